@@ -23,10 +23,11 @@ public class HellWave : ModuleRules
 			"Niagara"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] { "AssetRegistry" });
 
 		PublicIncludePaths.AddRange(new string[] {
 			"HellWave",
+			"HellWave/Systems",
 			"HellWave/Variant_Horror",
 			"HellWave/Variant_Horror/UI",
 			"HellWave/Variant_Shooter",
@@ -2,7 +2,158 @@
 
 #include "HellWave.h"
 #include "Modules/ModuleManager.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/PlayerController.h"
+#include "EngineUtils.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, HellWave, "HellWave" );
 
-DEFINE_LOG_CATEGORY(LogHellWave)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogHellWave)
+
+namespace
+{
+	/** Sample rays fired across the player's view, per axis */
+	constexpr int32 TraceShapeSamplesPerAxis = 9;
+
+	/** Length of each sample ray. Matches the NPC aim range, the longest gameplay trace */
+	constexpr float TraceShapeSampleRange = 10000.0f;
+
+	/**
+	 *  Fires a grid of sample traces across the player's view on the Visibility, Hitscan and AISight channels,
+	 *  and logs how many collision shapes each query tested on average and at most
+	 *  A shape counts as tested when it doesn't ignore the channel and its bounds cross the ray before the ray's blocking hit,
+	 *  which is the set the broadphase hands to the narrowphase. Also logs how many primitives generate overlaps
+	 */
+	void LogTraceShapes(UWorld* World)
+	{
+		APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		if (!PlayerController)
+		{
+			UE_LOG(LogHellWave, Warning, TEXT("HellWave.TraceShapes needs a local player to trace from."));
+			return;
+		}
+
+		/** Bounds of one collision shape and whether each channel can hit it */
+		struct FShape
+		{
+			FBox Bounds;
+			ECollisionResponse Responses[3];
+		};
+
+		// Visibility is what hitscan, aim and sight traces used before they got their own channels
+		const TCHAR* ChannelNames[] = { TEXT("Visibility"), TEXT("Hitscan"), TEXT("AISight") };
+		const ECollisionChannel Channels[] = { ECC_Visibility, ECC_HellWaveHitscan, ECC_HellWaveAISight };
+
+		TArray<FShape> Shapes;
+		int32 OverlapPrimitives = 0;
+
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			TInlineComponentArray<UPrimitiveComponent*> Primitives(*It);
+
+			for (const UPrimitiveComponent* Primitive : Primitives)
+			{
+				if (!Primitive->IsRegistered())
+				{
+					continue;
+				}
+
+				if (Primitive->GetGenerateOverlapEvents())
+				{
+					++OverlapPrimitives;
+				}
+
+				if (!Primitive->IsQueryCollisionEnabled())
+				{
+					continue;
+				}
+
+				FShape Shape;
+				for (int32 ChannelIndex = 0; ChannelIndex < UE_ARRAY_COUNT(Channels); ++ChannelIndex)
+				{
+					Shape.Responses[ChannelIndex] = Primitive->GetCollisionResponseToChannel(Channels[ChannelIndex]);
+				}
+
+				// Skeletal meshes are tested per physics asset body
+				const USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Primitive);
+				if (SkeletalMesh && !SkeletalMesh->Bodies.IsEmpty())
+				{
+					for (const FBodyInstance* Body : SkeletalMesh->Bodies)
+					{
+						if (Body && Body->IsValidBodyInstance())
+						{
+							Shape.Bounds = Body->GetBodyBounds();
+							Shapes.Add(Shape);
+						}
+					}
+				}
+				else
+				{
+					Shape.Bounds = Primitive->Bounds.GetBox();
+					Shapes.Add(Shape);
+				}
+			}
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HellWaveTraceShapes), false, PlayerController->GetPawn());
+
+		UE_LOG(LogHellWave, Log, TEXT("Shapes tested per trace in %s, %d sample traces from the player's view. %d primitives generate overlaps"),
+			*World->GetName(), TraceShapeSamplesPerAxis * TraceShapeSamplesPerAxis, OverlapPrimitives);
+
+		for (int32 ChannelIndex = 0; ChannelIndex < UE_ARRAY_COUNT(Channels); ++ChannelIndex)
+		{
+			int32 TotalTested = 0;
+			int32 MaxTested = 0;
+
+			for (int32 PitchStep = 0; PitchStep < TraceShapeSamplesPerAxis; ++PitchStep)
+			{
+				for (int32 YawStep = 0; YawStep < TraceShapeSamplesPerAxis; ++YawStep)
+				{
+					// Spread the samples over a 60 by 30 degree window around the view direction
+					const float Yaw = FMath::Lerp(-30.0f, 30.0f, YawStep / float(TraceShapeSamplesPerAxis - 1));
+					const float Pitch = FMath::Lerp(-15.0f, 15.0f, PitchStep / float(TraceShapeSamplesPerAxis - 1));
+					const FVector Direction = (ViewRotation + FRotator(Pitch, Yaw, 0.0f)).Vector();
+
+					// The query stops at its blocking hit, so shapes past it are never tested
+					FVector End = ViewLocation + Direction * TraceShapeSampleRange;
+
+					FHitResult Hit;
+					if (World->LineTraceSingleByChannel(Hit, ViewLocation, End, Channels[ChannelIndex], QueryParams))
+					{
+						End = Hit.Location;
+					}
+
+					const FVector Extent = End - ViewLocation;
+					int32 Tested = 0;
+
+					for (const FShape& Shape : Shapes)
+					{
+						if (Shape.Responses[ChannelIndex] != ECR_Ignore && FMath::LineBoxIntersection(Shape.Bounds, ViewLocation, End, Extent))
+						{
+							++Tested;
+						}
+					}
+
+					TotalTested += Tested;
+					MaxTested = FMath::Max(MaxTested, Tested);
+				}
+			}
+
+			UE_LOG(LogHellWave, Log, TEXT("  %-10s %6.1f shapes per trace on average, %4d at most"),
+				ChannelNames[ChannelIndex], TotalTested / float(TraceShapeSamplesPerAxis * TraceShapeSamplesPerAxis), MaxTested);
+		}
+	}
+
+	/** Console command to compare the shapes tested per trace by the old visibility traces against the dedicated channels */
+	FAutoConsoleCommandWithWorld TraceShapesCommand(
+		TEXT("HellWave.TraceShapes"),
+		TEXT("Fires sample traces across the player's view and logs how many collision shapes each Visibility, Hitscan and AISight trace tests"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogTraceShapes));
+}
@@ -3,6 +3,16 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
 /** Main log category used across the project */
-DECLARE_LOG_CATEGORY_EXTERN(LogHellWave, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(LogHellWave, Log, All);
+
+/** Stat group for project runtime counters. Use "stat HellWave" to display */
+DECLARE_STATS_GROUP(TEXT("HellWave"), STATGROUP_HellWave, STATCAT_Advanced);
+
+/** Trace channel for weapon hitscan and aim traces. Set up in DefaultEngine.ini */
+#define ECC_HellWaveHitscan ECC_GameTraceChannel2
+
+/** Trace channel for AI line of sight. Set up in DefaultEngine.ini */
+#define ECC_HellWaveAISight ECC_GameTraceChannel3
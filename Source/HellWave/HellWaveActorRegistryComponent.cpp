@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveActorRegistryComponent.h"
+#include "HellWaveActorRegistrySubsystem.h"
+#include "Engine/World.h"
+
+UHellWaveActorRegistryComponent::UHellWaveActorRegistryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UHellWaveActorRegistryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
+	{
+		Registry->RegisterActor(GetOwner(), RegistryTags);
+	}
+}
+
+void UHellWaveActorRegistryComponent::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
+	{
+		Registry->UnregisterActor(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
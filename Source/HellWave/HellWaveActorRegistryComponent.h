@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HellWaveActorRegistryComponent.generated.h"
+
+/**
+ *  Lightweight component that opts its owner into the actor registry
+ *  The owner is indexed by its class, its actor tags and any extra registry tags
+ *  while it's in play
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class HELLWAVE_API UHellWaveActorRegistryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Tags to index the owner under in addition to its own actor tags */
+	UPROPERTY(EditAnywhere, Category="Registry")
+	TArray<FName> RegistryTags;
+
+public:
+
+	UHellWaveActorRegistryComponent();
+
+protected:
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+};
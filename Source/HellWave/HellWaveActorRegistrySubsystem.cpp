@@ -0,0 +1,290 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveActorRegistrySubsystem.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+	/** Shared empty result for lookups that miss */
+	const TArray<TWeakObjectPtr<AActor>> EmptyActorList;
+}
+
+void UHellWaveActorRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// follow level streaming so streamed actors enter and leave the index
+	FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UHellWaveActorRegistrySubsystem::OnLevelAddedToWorld);
+	FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UHellWaveActorRegistrySubsystem::OnLevelRemovedFromWorld);
+}
+
+void UHellWaveActorRegistrySubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
+	FWorldDelegates::LevelRemovedFromWorld.RemoveAll(this);
+
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	ActorsByTag.Empty();
+	ActorsByClass.Empty();
+	Entries.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHellWaveActorRegistrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// catch runtime spawned actors
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UHellWaveActorRegistrySubsystem::OnActorSpawned));
+
+	// index anything tracked before play started
+	ConsiderLoadedLevels();
+}
+
+void UHellWaveActorRegistrySubsystem::TrackTag(FName Tag)
+{
+	if (Tag.IsNone() || TrackedTags.Contains(Tag))
+	{
+		return;
+	}
+
+	TrackedTags.Add(Tag);
+
+	// one-time scan for actors that were loaded before the tag was tracked
+	ConsiderLoadedLevels();
+}
+
+void UHellWaveActorRegistrySubsystem::TrackClass(TSubclassOf<AActor> ActorClass)
+{
+	if (!ActorClass || TrackedClasses.Contains(ActorClass.Get()))
+	{
+		return;
+	}
+
+	TrackedClasses.Add(ActorClass.Get());
+
+	// one-time scan for actors that were loaded before the class was tracked
+	ConsiderLoadedLevels();
+}
+
+void UHellWaveActorRegistrySubsystem::RegisterActor(AActor* Actor, const TArray<FName>& ExtraTags)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	// an actor that was auto-registered first still picks up its component's extra tags
+	if (FRegistryEntry* Existing = Entries.Find(Actor))
+	{
+		for (const FName& Tag : ExtraTags)
+		{
+			if (!Existing->Tags.Contains(Tag))
+			{
+				Existing->Tags.Add(Tag);
+				ActorsByTag.FindOrAdd(Tag).Add(Actor);
+			}
+		}
+
+		return;
+	}
+
+	FRegistryEntry& Entry = Entries.Add(Actor);
+
+	// file under each of the actor's tags
+	for (const FName& Tag : Actor->Tags)
+	{
+		Entry.Tags.AddUnique(Tag);
+	}
+
+	for (const FName& Tag : ExtraTags)
+	{
+		Entry.Tags.AddUnique(Tag);
+	}
+
+	for (const FName& Tag : Entry.Tags)
+	{
+		ActorsByTag.FindOrAdd(Tag).Add(Actor);
+	}
+
+	// file under the class hierarchy so base class lookups are a single fetch
+	for (const UClass* Class = Actor->GetClass(); Class && Class != AActor::StaticClass(); Class = Class->GetSuperClass())
+	{
+		Entry.Classes.Add(Class);
+		ActorsByClass.FindOrAdd(Class).Add(Actor);
+	}
+
+	// drop the actor when it's destroyed or its level is streamed out
+	Actor->OnEndPlay.AddUniqueDynamic(this, &UHellWaveActorRegistrySubsystem::OnRegisteredActorEndPlay);
+}
+
+void UHellWaveActorRegistrySubsystem::UnregisterActor(AActor* Actor)
+{
+	RemoveEntry(TWeakObjectPtr<AActor>(Actor));
+}
+
+void UHellWaveActorRegistrySubsystem::RemoveEntry(const TWeakObjectPtr<AActor>& WeakActor)
+{
+	FRegistryEntry Entry;
+	if (!Entries.RemoveAndCopyValue(WeakActor, Entry))
+	{
+		return;
+	}
+
+	for (const FName& Tag : Entry.Tags)
+	{
+		if (TArray<TWeakObjectPtr<AActor>>* List = ActorsByTag.Find(Tag))
+		{
+			List->RemoveSingleSwap(WeakActor);
+		}
+	}
+
+	for (const UClass* Class : Entry.Classes)
+	{
+		if (TArray<TWeakObjectPtr<AActor>>* List = ActorsByClass.Find(Class))
+		{
+			List->RemoveSingleSwap(WeakActor);
+		}
+	}
+
+	if (AActor* Actor = WeakActor.Get())
+	{
+		Actor->OnEndPlay.RemoveDynamic(this, &UHellWaveActorRegistrySubsystem::OnRegisteredActorEndPlay);
+	}
+}
+
+const TArray<TWeakObjectPtr<AActor>>& UHellWaveActorRegistrySubsystem::GetActorsWithTag(FName Tag) const
+{
+	const TArray<TWeakObjectPtr<AActor>>* List = ActorsByTag.Find(Tag);
+	return List ? *List : EmptyActorList;
+}
+
+const TArray<TWeakObjectPtr<AActor>>& UHellWaveActorRegistrySubsystem::GetActorsOfClass(TSubclassOf<AActor> ActorClass) const
+{
+	const TArray<TWeakObjectPtr<AActor>>* List = ActorsByClass.Find(ActorClass.Get());
+	return List ? *List : EmptyActorList;
+}
+
+bool UHellWaveActorRegistrySubsystem::IsRegistered(const AActor* Actor) const
+{
+	return Entries.Contains(TWeakObjectPtr<AActor>(const_cast<AActor*>(Actor)));
+}
+
+void UHellWaveActorRegistrySubsystem::ConsiderActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || Entries.Contains(Actor))
+	{
+		return;
+	}
+
+	// does the actor carry a tracked tag?
+	bool bTracked = false;
+	for (const FName& Tag : Actor->Tags)
+	{
+		if (TrackedTags.Contains(Tag))
+		{
+			bTracked = true;
+			break;
+		}
+	}
+
+	// does the actor derive from a tracked class?
+	if (!bTracked)
+	{
+		for (const UClass* Class : TrackedClasses)
+		{
+			if (Actor->IsA(Class))
+			{
+				bTracked = true;
+				break;
+			}
+		}
+	}
+
+	if (bTracked)
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UHellWaveActorRegistrySubsystem::ConsiderLevel(ULevel* Level)
+{
+	if (!Level)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		ConsiderActor(Actor);
+	}
+}
+
+void UHellWaveActorRegistrySubsystem::ConsiderLoadedLevels()
+{
+	if (UWorld* World = GetWorld())
+	{
+		for (ULevel* Level : World->GetLevels())
+		{
+			ConsiderLevel(Level);
+		}
+	}
+}
+
+void UHellWaveActorRegistrySubsystem::OnActorSpawned(AActor* Actor)
+{
+	ConsiderActor(Actor);
+}
+
+void UHellWaveActorRegistrySubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		ConsiderLevel(Level);
+	}
+}
+
+void UHellWaveActorRegistrySubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// a null level means every streamed level is being removed
+	if (!Level)
+	{
+		TArray<TWeakObjectPtr<AActor>> RegisteredActors;
+		Entries.GetKeys(RegisteredActors);
+
+		for (const TWeakObjectPtr<AActor>& Actor : RegisteredActors)
+		{
+			if (!Actor.IsValid() || Actor->GetLevel() != World->PersistentLevel)
+			{
+				RemoveEntry(Actor);
+			}
+		}
+
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor)
+		{
+			UnregisterActor(Actor);
+		}
+	}
+}
+
+void UHellWaveActorRegistrySubsystem::OnRegisteredActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterActor(Actor);
+}
@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveActorRegistrySubsystem.generated.h"
+
+class ULevel;
+
+/**
+ *  World subsystem that keeps opted-in actors indexed by tag and by class
+ *  Actors opt in through a UHellWaveActorRegistryComponent, or automatically when
+ *  they carry a tracked tag or derive from a tracked class
+ *  Lookups return the cached lists directly, so no actor iteration happens at query time
+ *  Tags and classes are captured when the actor is registered
+ */
+UCLASS()
+class HELLWAVE_API UHellWaveActorRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Keys a registered actor was filed under, so removal doesn't need to search every list */
+	struct FRegistryEntry
+	{
+		TArray<FName> Tags;
+		TArray<const UClass*> Classes;
+	};
+
+	/** Registered actors, keyed by tag */
+	TMap<FName, TArray<TWeakObjectPtr<AActor>>> ActorsByTag;
+
+	/** Registered actors, keyed by their class and every superclass below AActor */
+	TMap<const UClass*, TArray<TWeakObjectPtr<AActor>>> ActorsByClass;
+
+	/** Index keys for every registered actor */
+	TMap<TWeakObjectPtr<AActor>, FRegistryEntry> Entries;
+
+	/** Tags that cause actors to be registered automatically */
+	TSet<FName> TrackedTags;
+
+	/** Classes that cause actors to be registered automatically */
+	TArray<const UClass*> TrackedClasses;
+
+	/** Handle for the world's actor spawned callback */
+	FDelegateHandle ActorSpawnedHandle;
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Hooks into the world once it's ready to spawn actors */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+public:
+
+	/** Auto-registers every loaded, streamed in or spawned actor that carries this tag */
+	void TrackTag(FName Tag);
+
+	/** Auto-registers every loaded, streamed in or spawned actor of this class */
+	void TrackClass(TSubclassOf<AActor> ActorClass);
+
+	/** Adds the actor to the tag and class lists. Extra tags are indexed along with the actor's own, and merged in if the actor is already registered */
+	void RegisterActor(AActor* Actor, const TArray<FName>& ExtraTags = TArray<FName>());
+
+	/** Removes the actor from every list it was filed under */
+	void UnregisterActor(AActor* Actor);
+
+	/** Returns every registered actor carrying the tag */
+	const TArray<TWeakObjectPtr<AActor>>& GetActorsWithTag(FName Tag) const;
+
+	/** Returns every registered actor of the class or one of its subclasses */
+	const TArray<TWeakObjectPtr<AActor>>& GetActorsOfClass(TSubclassOf<AActor> ActorClass) const;
+
+	/** Returns true if the actor is currently registered */
+	bool IsRegistered(const AActor* Actor) const;
+
+protected:
+
+	/** Removes an index entry. Works for actors that have already been garbage collected */
+	void RemoveEntry(const TWeakObjectPtr<AActor>& WeakActor);
+
+	/** Registers the actor if it matches any tracked tag or class */
+	void ConsiderActor(AActor* Actor);
+
+	/** Runs ConsiderActor on every actor in the level */
+	void ConsiderLevel(ULevel* Level);
+
+	/** Runs ConsiderActor on every actor in every loaded level */
+	void ConsiderLoadedLevels();
+
+	/** Called when an actor is spawned in the world */
+	void OnActorSpawned(AActor* Actor);
+
+	/** Called when a streaming level finishes being added to a world */
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	/** Called when a streaming level is removed from a world */
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	/** Called when a registered actor leaves play */
+	UFUNCTION()
+	void OnRegisteredActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+};
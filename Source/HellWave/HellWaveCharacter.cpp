@@ -8,6 +8,7 @@
 #include "EnhancedInputComponent.h"
 #include "InputActionValue.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "HellWaveTeamComponent.h"
 #include "HellWave.h"
 
 AHellWaveCharacter::AHellWaveCharacter()
@@ -22,6 +23,7 @@ AHellWaveCharacter::AHellWaveCharacter()
 	FirstPersonMesh->SetOnlyOwnerSee(true);
 	FirstPersonMesh->FirstPersonPrimitiveType = EFirstPersonPrimitiveType::FirstPerson;
 	FirstPersonMesh->SetCollisionProfileName(FName("NoCollision"));
+	FirstPersonMesh->SetGenerateOverlapEvents(false);
 
 	// Create the Camera Component	
 	FirstPersonCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("First Person Camera"));
@@ -33,10 +35,16 @@ AHellWaveCharacter::AHellWaveCharacter()
 	FirstPersonCameraComponent->FirstPersonFieldOfView = 70.0f;
 	FirstPersonCameraComponent->FirstPersonScale = 0.6f;
 
+	// Create the team component
+	TeamComponent = CreateDefaultSubobject<UHellWaveTeamComponent>(TEXT("Team"));
+
 	// configure the character comps
 	GetMesh()->SetOwnerNoSee(true);
 	GetMesh()->FirstPersonPrimitiveType = EFirstPersonPrimitiveType::WorldSpaceRepresentation;
 
+	// Nothing listens to mesh overlaps. The capsule still generates them for pickups
+	GetMesh()->SetGenerateOverlapEvents(false);
+
 	GetCapsuleComponent()->SetCapsuleSize(34.0f, 96.0f);
 
 	// Configure character movement
@@ -44,6 +52,16 @@ AHellWaveCharacter::AHellWaveCharacter()
 	GetCharacterMovement()->AirControl = 0.5f;
 }
 
+void AHellWaveCharacter::SetGenericTeamId(const FGenericTeamId& NewTeamID)
+{
+	TeamComponent->SetTeamId(NewTeamID);
+}
+
+FGenericTeamId AHellWaveCharacter::GetGenericTeamId() const
+{
+	return TeamComponent->GetTeamId();
+}
+
 void AHellWaveCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {	
 	// Set up action bindings
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveTeamComponent.h"
+#include "HellWaveCharacter.h"
+#include "GameFramework/Actor.h"
+
+UHellWaveTeamComponent::UHellWaveTeamComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UHellWaveTeamComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AddState(EHellWaveActorState::Alive);
+}
+
+bool UHellWaveTeamComponent::ShouldIgnoreDamageFrom(const AActor* DamageInstigator) const
+{
+	// Self damage, such as splash from our own rockets, always applies
+	if (bFriendlyFire || !DamageInstigator || DamageInstigator == GetOwner())
+	{
+		return false;
+	}
+
+	const UHellWaveTeamComponent* InstigatorTeam = FindTeamComponent(DamageInstigator);
+	return InstigatorTeam && GetAttitudeTowards(InstigatorTeam->GetTeamId()) == ETeamAttitude::Friendly;
+}
+
+UHellWaveTeamComponent* UHellWaveTeamComponent::FindTeamComponent(const AActor* Actor)
+{
+	// Characters cache their component, so the common case skips the component search
+	if (const AHellWaveCharacter* Character = Cast<AHellWaveCharacter>(Actor))
+	{
+		return Character->GetTeamComponent();
+	}
+
+	return Actor ? Actor->FindComponentByClass<UHellWaveTeamComponent>() : nullptr;
+}
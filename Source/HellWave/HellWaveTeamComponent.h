@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GenericTeamAgentInterface.h"
+#include "HellWaveTeamComponent.generated.h"
+
+/**
+ *  Gameplay state flags for a team member
+ */
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EHellWaveActorState : uint8
+{
+	None		= 0,
+	Alive		= 1 << 0,
+	Dead		= 1 << 1,
+	Burning		= 1 << 2
+};
+ENUM_CLASS_FLAGS(EHellWaveActorState);
+
+/**
+ *  Holds its owner's team and a compact gameplay state bitfield
+ *  Friend or foe and alive or dead checks are a team compare and a bit test, instead of actor tag searches
+ *  Characters forward IGenericTeamAgentInterface to it, so AI perception affiliation filtering sees the same team
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class HELLWAVE_API UHellWaveTeamComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Team the owner belongs to. 255 is no team */
+	UPROPERTY(EditAnywhere, Category="Team")
+	uint8 TeamId = FGenericTeamId::NoTeam;
+
+	/** If true, damage from members of the same team is applied */
+	UPROPERTY(EditAnywhere, Category="Team")
+	bool bFriendlyFire = false;
+
+	/** Current gameplay state */
+	UPROPERTY(VisibleInstanceOnly, Category="Team", meta = (Bitmask, BitmaskEnum = "/Script/HellWave.EHellWaveActorState"))
+	uint8 StateFlags = 0;
+
+public:
+
+	UHellWaveTeamComponent();
+
+protected:
+
+	/** Marks the owner as alive */
+	virtual void BeginPlay() override;
+
+public:
+
+	/** Returns the team as a generic team ID */
+	FGenericTeamId GetTeamId() const { return FGenericTeamId(TeamId); }
+
+	/** Sets the team */
+	void SetTeamId(const FGenericTeamId& InTeamId) { TeamId = InTeamId.GetId(); }
+
+	/** Returns the owner's attitude towards another team */
+	ETeamAttitude::Type GetAttitudeTowards(const FGenericTeamId& OtherTeamId) const { return FGenericTeamId::GetAttitude(GetTeamId(), OtherTeamId); }
+
+	/** Returns true if the owner has every passed state flag */
+	bool HasState(EHellWaveActorState State) const { return EnumHasAllFlags(static_cast<EHellWaveActorState>(StateFlags), State); }
+
+	/** Returns true if the owner has any of the passed state flags */
+	bool HasAnyState(EHellWaveActorState State) const { return EnumHasAnyFlags(static_cast<EHellWaveActorState>(StateFlags), State); }
+
+	/** Raises state flags */
+	void AddState(EHellWaveActorState State) { StateFlags |= static_cast<uint8>(State); }
+
+	/** Clears state flags */
+	void RemoveState(EHellWaveActorState State) { StateFlags &= ~static_cast<uint8>(State); }
+
+	/** Returns true if the owner is alive */
+	bool IsAlive() const { return HasState(EHellWaveActorState::Alive); }
+
+	/** Returns true if the owner has died */
+	bool IsDead() const { return HasState(EHellWaveActorState::Dead); }
+
+	/** Swaps the alive flag for the dead flag and clears any transient state */
+	void MarkDead() { StateFlags = static_cast<uint8>(EHellWaveActorState::Dead); }
+
+	/** Returns true if damage from the passed instigator should be ignored as friendly fire */
+	bool ShouldIgnoreDamageFrom(const AActor* DamageInstigator) const;
+
+	/** Returns the team component of an actor, or nullptr if it has none */
+	static UHellWaveTeamComponent* FindTeamComponent(const AActor* Actor);
+};
@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveArenaBakeData.h"
+
+int32 UHellWaveArenaBakeData::FindZone(const FVector& Location) const
+{
+	int32 ClosestZone = INDEX_NONE;
+	double ClosestDistSquared = TNumericLimits<double>::Max();
+
+	for (int32 ZoneIndex = 0; ZoneIndex < Zones.Num(); ++ZoneIndex)
+	{
+		const FBox& Bounds = Zones[ZoneIndex].Bounds;
+
+		// inside the zone is an exact match
+		if (Bounds.IsInsideOrOn(Location))
+		{
+			return ZoneIndex;
+		}
+
+		const double DistSquared = Bounds.ComputeSquaredDistanceToPoint(Location);
+		if (DistSquared < ClosestDistSquared)
+		{
+			ClosestDistSquared = DistSquared;
+			ClosestZone = ZoneIndex;
+		}
+	}
+
+	return ClosestZone;
+}
+
+void UHellWaveArenaBakeData::SelectSpawnTransforms(const FVector& PlayerLocation, int32 Count, const FHellWaveSpawnScoring& Scoring, TArray<FTransform>& OutTransforms) const
+{
+	OutTransforms.Reset();
+
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	const int32 PlayerZone = FindZone(PlayerLocation);
+	const uint32 PlayerZoneBit = PlayerZone != INDEX_NONE ? (1u << PlayerZone) : 0u;
+	const float MinDistSquared = FMath::Square(Scoring.MinDistance);
+
+	// score every usable point in a single pass over the baked table
+	TArray<TPair<float, int32>, TInlineAllocator<64>> Scored;
+	Scored.Reserve(SpawnPoints.Num());
+
+	for (int32 PointIndex = 0; PointIndex < SpawnPoints.Num(); ++PointIndex)
+	{
+		const FHellWaveBakedSpawnPoint& Point = SpawnPoints[PointIndex];
+
+		if (!Point.IsReachable())
+		{
+			continue;
+		}
+
+		const float DistSquared = FVector::DistSquared(Point.Location, PlayerLocation);
+		if (DistSquared < MinDistSquared)
+		{
+			continue;
+		}
+
+		// prefer points near the preferred distance that the player can't see
+		float Score = -FMath::Abs(FMath::Sqrt(DistSquared) - Scoring.PreferredDistance) / Scoring.PreferredDistance;
+
+		if (Point.VisibleZoneMask & PlayerZoneBit)
+		{
+			Score -= Scoring.VisiblePenalty;
+		}
+
+		Score += FMath::FRand() * Scoring.RandomJitter;
+
+		Scored.Emplace(Score, PointIndex);
+	}
+
+	Scored.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+
+	// hand out the point itself first, then its free ring slots
+	for (const TPair<float, int32>& Entry : Scored)
+	{
+		const FHellWaveBakedSpawnPoint& Point = SpawnPoints[Entry.Value];
+		const FRotator Facing(0.0f, Point.Yaw, 0.0f);
+
+		OutTransforms.Emplace(Facing, Point.Location);
+
+		for (int32 SlotIndex = 0; SlotIndex < NumSpawnSlots && OutTransforms.Num() < Count; ++SlotIndex)
+		{
+			if (Point.FreeSlotMask & (1 << SlotIndex))
+			{
+				OutTransforms.Emplace(Facing, Point.Location + GetSpawnSlotOffset(SlotIndex));
+			}
+		}
+
+		if (OutTransforms.Num() >= Count)
+		{
+			break;
+		}
+	}
+
+	if (OutTransforms.Num() > Count)
+	{
+		OutTransforms.SetNum(Count);
+	}
+}
+
+FVector UHellWaveArenaBakeData::GetSpawnSlotOffset(int32 SlotIndex) const
+{
+	const float Angle = (2.0f * UE_PI * SlotIndex) / NumSpawnSlots;
+	return FVector(FMath::Cos(Angle) * SpawnSlotRadius, FMath::Sin(Angle) * SpawnSlotRadius, 0.0f);
+}
+
+int32 UHellWaveArenaBakeData::GetVisibilityCell(const FVector& Location) const
+{
+	const FVector Local = (Location - VisibilityBounds.Min) / VisibilityCellSize;
+
+	const int32 X = FMath::FloorToInt32(Local.X);
+	const int32 Y = FMath::FloorToInt32(Local.Y);
+	const int32 Z = FMath::FloorToInt32(Local.Z);
+
+	if (X < 0 || Y < 0 || Z < 0 || X >= VisibilityDims.X || Y >= VisibilityDims.Y || Z >= VisibilityDims.Z)
+	{
+		return INDEX_NONE;
+	}
+
+	return X + VisibilityDims.X * (Y + VisibilityDims.Y * Z);
+}
+
+FVector UHellWaveArenaBakeData::GetVisibilityCellCenter(int32 CellIndex) const
+{
+	const int32 X = CellIndex % VisibilityDims.X;
+	const int32 Y = (CellIndex / VisibilityDims.X) % VisibilityDims.Y;
+	const int32 Z = CellIndex / (VisibilityDims.X * VisibilityDims.Y);
+
+	return VisibilityBounds.Min + (FVector(X, Y, Z) + 0.5f) * VisibilityCellSize;
+}
+
+bool UHellWaveArenaBakeData::CouldSee(const FVector& From, const FVector& To) const
+{
+	if (!HasVisibility())
+	{
+		return true;
+	}
+
+	const int32 FromCell = GetVisibilityCell(From);
+	const int32 ToCell = GetVisibilityCell(To);
+
+	// anything outside the baked volume needs a real trace
+	if (FromCell == INDEX_NONE || ToCell == INDEX_NONE)
+	{
+		return true;
+	}
+
+	return CouldCellsSee(FromCell, ToCell);
+}
+
+int32 UHellWaveArenaBakeData::SelectTacticalNode(const FVector& TargetLocation, const FVector& SelfLocation, const FHellWaveTacticalScoring& Scoring) const
+{
+	const int32 TargetZone = FindZone(TargetLocation);
+	const int32 SelfZone = FindZone(SelfLocation);
+
+	if (TargetZone == INDEX_NONE || TacticalZoneDistances.Num() != TacticalNodes.Num() * Zones.Num())
+	{
+		return INDEX_NONE;
+	}
+
+	const uint32 TargetZoneBit = 1u << TargetZone;
+	const float MinDistSquared = FMath::Square(Scoring.MinDistance);
+
+	int32 BestNode = INDEX_NONE;
+	float BestScore = TNumericLimits<float>::Lowest();
+
+	for (int32 NodeIndex = 0; NodeIndex < TacticalNodes.Num(); ++NodeIndex)
+	{
+		const FHellWaveTacticalNode& Node = TacticalNodes[NodeIndex];
+
+		if (Scoring.bRequireLineOfSight && !(Node.VisibleZoneMask & TargetZoneBit))
+		{
+			continue;
+		}
+
+		// skip nodes the NPC can't walk to
+		const float TravelDistance = GetTacticalZoneDistance(NodeIndex, SelfZone);
+		if (TravelDistance < 0.0f)
+		{
+			continue;
+		}
+
+		const float DistSquared = FVector::DistSquared(Node.Location, TargetLocation);
+		if (DistSquared < MinDistSquared)
+		{
+			continue;
+		}
+
+		float Score = 0.0f;
+		Score += (Node.CoverZoneMask & TargetZoneBit) ? Scoring.CoverWeight : 0.0f;
+		Score += (Node.FlankZoneMask & TargetZoneBit) ? Scoring.FlankWeight : 0.0f;
+		Score += (Node.HighGroundZoneMask & TargetZoneBit) ? Scoring.HighGroundWeight : 0.0f;
+		Score -= Scoring.RangeWeight * FMath::Abs(FMath::Sqrt(DistSquared) - Scoring.PreferredDistance) / Scoring.PreferredDistance;
+		Score -= Scoring.TravelWeight * FMath::Min(TravelDistance / Scoring.MaxTravelDistance, 1.0f);
+		Score += FMath::FRand() * Scoring.RandomJitter;
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestNode = NodeIndex;
+		}
+	}
+
+	return BestNode;
+}
@@ -0,0 +1,273 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HellWaveArenaBakeData.generated.h"
+
+/**
+ *  A named region of the arena, used to summarize visibility and player position
+ */
+USTRUCT()
+struct FHellWaveArenaZone
+{
+	GENERATED_BODY()
+
+	/** Name of the zone actor this was baked from */
+	UPROPERTY(VisibleAnywhere, Category="Zone")
+	FName ZoneName;
+
+	/** World space bounds of the zone */
+	UPROPERTY(VisibleAnywhere, Category="Zone")
+	FBox Bounds = FBox(ForceInit);
+};
+
+/**
+ *  Precomputed metadata for a single enemy spawn point
+ */
+USTRUCT()
+struct FHellWaveBakedSpawnPoint
+{
+	GENERATED_BODY()
+
+	/** Spawn location, projected onto the navmesh when possible */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Point")
+	FVector Location = FVector::ZeroVector;
+
+	/** Spawn facing */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Point")
+	float Yaw = 0.0f;
+
+	/** Navmesh path length to the arena center. Negative if unreachable */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Point")
+	float PathLength = -1.0f;
+
+	/** One bit per arena zone with line of sight to this spawn point */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Point")
+	uint32 VisibleZoneMask = 0;
+
+	/** One bit per ring slot around the spawn point that has room for an NPC capsule */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Point")
+	uint8 FreeSlotMask = 0;
+
+	/** Returns true if the spawn point is connected to the arena navmesh */
+	bool IsReachable() const { return PathLength >= 0.0f; }
+};
+
+/**
+ *  Tuning for runtime spawn point scoring
+ */
+USTRUCT(BlueprintType)
+struct FHellWaveSpawnScoring
+{
+	GENERATED_BODY()
+
+	/** Spawn points closer than this to the player are skipped */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0, Units = "cm"))
+	float MinDistance = 800.0f;
+
+	/** Spawn points score best around this distance from the player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 1, Units = "cm"))
+	float PreferredDistance = 2000.0f;
+
+	/** Score penalty for spawn points visible from the player's zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float VisiblePenalty = 1.0f;
+
+	/** Random score variation so waves don't always pick the same points */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float RandomJitter = 0.25f;
+};
+
+/**
+ *  Summary flags for a baked tactical node
+ */
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EHellWaveTacticalFlags : uint8
+{
+	None		= 0,
+	Cover		= 1 << 0,
+	Flank		= 1 << 1,
+	HighGround	= 1 << 2
+};
+ENUM_CLASS_FLAGS(EHellWaveTacticalFlags);
+
+/**
+ *  A baked NPC position with precomputed per-zone tactical properties
+ *  Zone masks hold one bit per arena zone
+ */
+USTRUCT()
+struct FHellWaveTacticalNode
+{
+	GENERATED_BODY()
+
+	/** Node location on the navmesh */
+	UPROPERTY(VisibleAnywhere, Category="Tactical Node")
+	FVector Location = FVector::ZeroVector;
+
+	/** Summary of the zone masks, for quick filtering */
+	UPROPERTY(VisibleAnywhere, Category="Tactical Node", meta = (Bitmask, BitmaskEnum = "/Script/HellWave.EHellWaveTacticalFlags"))
+	uint8 Flags = 0;
+
+	/** Zones visible from the node at eye height */
+	UPROPERTY(VisibleAnywhere, Category="Tactical Node")
+	uint32 VisibleZoneMask = 0;
+
+	/** Zones the node can shoot at standing but is hidden from when crouched */
+	UPROPERTY(VisibleAnywhere, Category="Tactical Node")
+	uint32 CoverZoneMask = 0;
+
+	/** Zones the node sees from off the arena's main line, angled away from the arena center */
+	UPROPERTY(VisibleAnywhere, Category="Tactical Node")
+	uint32 FlankZoneMask = 0;
+
+	/** Zones the node overlooks from above */
+	UPROPERTY(VisibleAnywhere, Category="Tactical Node")
+	uint32 HighGroundZoneMask = 0;
+};
+
+/**
+ *  Tuning for runtime tactical node scoring
+ */
+USTRUCT(BlueprintType)
+struct FHellWaveTacticalScoring
+{
+	GENERATED_BODY()
+
+	/** If true, only nodes with line of sight to the target's zone are considered */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring")
+	bool bRequireLineOfSight = true;
+
+	/** Nodes score best around this distance from the target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 1, Units = "cm"))
+	float PreferredDistance = 1500.0f;
+
+	/** Nodes closer than this to the target are skipped */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0, Units = "cm"))
+	float MinDistance = 400.0f;
+
+	/** Nav distance at which travel cost reaches its full weight */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 1, Units = "cm"))
+	float MaxTravelDistance = 3000.0f;
+
+	/** Score for a node giving cover from the target's zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float CoverWeight = 1.0f;
+
+	/** Score for a node flanking the target's zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float FlankWeight = 0.5f;
+
+	/** Score for a node overlooking the target's zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float HighGroundWeight = 0.5f;
+
+	/** Penalty for distance away from the preferred distance */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float RangeWeight = 1.0f;
+
+	/** Penalty for nav distance from the NPC's zone to the node */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float TravelWeight = 0.5f;
+
+	/** Random score variation so NPCs spread out over similar nodes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scoring", meta = (ClampMin = 0))
+	float RandomJitter = 0.2f;
+};
+
+/**
+ *  Editor-baked static data for a HellWave arena
+ *  Produced by AHellWaveArenaBakeVolume and consumed at runtime through UHellWaveArenaDataSubsystem
+ */
+UCLASS(BlueprintType)
+class HELLWAVE_API UHellWaveArenaBakeData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Number of ring slots baked around each spawn point */
+	static constexpr int32 NumSpawnSlots = 8;
+
+	/** Max number of zones. Zone sets are stored as 32 bit masks */
+	static constexpr int32 MaxZones = 32;
+
+	/** Arena zones, in bake order */
+	UPROPERTY(VisibleAnywhere, Category="Zones")
+	TArray<FHellWaveArenaZone> Zones;
+
+	/** Baked enemy spawn points */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Points")
+	TArray<FHellWaveBakedSpawnPoint> SpawnPoints;
+
+	/** Distance from a spawn point to its ring slots */
+	UPROPERTY(VisibleAnywhere, Category="Spawn Points", meta = (Units = "cm"))
+	float SpawnSlotRadius = 120.0f;
+
+	/** Max number of visibility cells. The cell-to-cell matrix grows with the square of this */
+	static constexpr int32 MaxVisibilityCells = 4096;
+
+	/** World space bounds covered by the visibility grid */
+	UPROPERTY(VisibleAnywhere, Category="Visibility")
+	FBox VisibilityBounds = FBox(ForceInit);
+
+	/** Edge length of a visibility cell */
+	UPROPERTY(VisibleAnywhere, Category="Visibility", meta = (Units = "cm"))
+	float VisibilityCellSize = 400.0f;
+
+	/** Number of visibility cells along each axis */
+	UPROPERTY(VisibleAnywhere, Category="Visibility")
+	FIntVector VisibilityDims = FIntVector::ZeroValue;
+
+	/** Cell-to-cell visibility bit matrix. Bit (A * NumCells + B) is set if any point in cell A may see cell B. Only cleared when the bake proved the pair occluded */
+	UPROPERTY()
+	TArray<uint64> VisibilityBits;
+
+	/** Baked tactical nodes */
+	UPROPERTY(VisibleAnywhere, Category="Tactical")
+	TArray<FHellWaveTacticalNode> TacticalNodes;
+
+	/** Nav path length from each tactical node to each zone, indexed [Node * NumZones + Zone]. Negative if unreachable */
+	UPROPERTY()
+	TArray<float> TacticalZoneDistances;
+
+public:
+
+	/** Returns the index of the zone containing the location, or the closest zone if none does. INDEX_NONE if there are no zones */
+	int32 FindZone(const FVector& Location) const;
+
+	/** Scores every baked spawn point against the player location and returns up to Count spawn transforms, best first */
+	void SelectSpawnTransforms(const FVector& PlayerLocation, int32 Count, const FHellWaveSpawnScoring& Scoring, TArray<FTransform>& OutTransforms) const;
+
+	/** Returns the world offset of a spawn ring slot */
+	FVector GetSpawnSlotOffset(int32 SlotIndex) const;
+
+	/** Returns true if a visibility grid has been baked */
+	bool HasVisibility() const { return !VisibilityBits.IsEmpty(); }
+
+	/** Returns the number of cells in the visibility grid */
+	int32 GetNumVisibilityCells() const { return VisibilityDims.X * VisibilityDims.Y * VisibilityDims.Z; }
+
+	/** Returns the visibility cell containing the location, or INDEX_NONE if it's outside the grid */
+	int32 GetVisibilityCell(const FVector& Location) const;
+
+	/** Returns the world space center of a visibility cell */
+	FVector GetVisibilityCellCenter(int32 CellIndex) const;
+
+	/** Returns true if the bake says cell A may see cell B */
+	bool CouldCellsSee(int32 CellA, int32 CellB) const
+	{
+		const int64 Bit = int64(CellA) * GetNumVisibilityCells() + CellB;
+		return (VisibilityBits[Bit >> 6] & (uint64(1) << (Bit & 63))) != 0;
+	}
+
+	/** Returns the nav distance from a tactical node to a zone. Negative if unreachable */
+	float GetTacticalZoneDistance(int32 NodeIndex, int32 ZoneIndex) const { return TacticalZoneDistances[NodeIndex * Zones.Num() + ZoneIndex]; }
+
+	/** Scores every tactical node against the target's zone in a single table scan. Returns the best node index, or INDEX_NONE */
+	int32 SelectTacticalNode(const FVector& TargetLocation, const FVector& SelfLocation, const FHellWaveTacticalScoring& Scoring) const;
+
+	/** Returns false only if the bake guarantees the two points can't see each other. Points outside the grid are always potentially visible */
+	bool CouldSee(const FVector& From, const FVector& To) const;
+};
@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveArenaDataSubsystem.h"
+#include "HellWaveArenaBakeData.h"
+#include "HellWave.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visibility Queries"), STAT_HellWaveVisibilityQueries, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visibility Traces Culled"), STAT_HellWaveVisibilityCulled, STATGROUP_HellWave);
+
+void UHellWaveArenaDataSubsystem::Deinitialize()
+{
+	if (VisibilityQueries > 0)
+	{
+		UE_LOG(LogHellWave, Log, TEXT("Visibility grid culled %lld of %lld traces (%.1f%%)."), VisibilityQueriesCulled, VisibilityQueries, 100.0 * VisibilityQueriesCulled / VisibilityQueries);
+	}
+
+	Super::Deinitialize();
+}
+
+void UHellWaveArenaDataSubsystem::SetBakeData(UHellWaveArenaBakeData* InBakeData)
+{
+	if (BakeData && BakeData != InBakeData)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("Replacing arena bake data %s with %s. Only one arena bake volume should be loaded at a time."), *GetNameSafe(BakeData), *GetNameSafe(InBakeData));
+	}
+
+	BakeData = InBakeData;
+}
+
+void UHellWaveArenaDataSubsystem::ClearBakeData(UHellWaveArenaBakeData* InBakeData)
+{
+	if (BakeData == InBakeData)
+	{
+		BakeData = nullptr;
+	}
+}
+
+bool UHellWaveArenaDataSubsystem::ShouldTraceVisibility(const FVector& From, const FVector& To)
+{
+	++VisibilityQueries;
+	INC_DWORD_STAT(STAT_HellWaveVisibilityQueries);
+
+	if (BakeData && !BakeData->CouldSee(From, To))
+	{
+		++VisibilityQueriesCulled;
+		INC_DWORD_STAT(STAT_HellWaveVisibilityCulled);
+		return false;
+	}
+
+	return true;
+}
+
+void UHellWaveArenaDataSubsystem::GetVisibilityQueryStats(int64& OutQueries, int64& OutCulled) const
+{
+	OutQueries = VisibilityQueries;
+	OutCulled = VisibilityQueriesCulled;
+}
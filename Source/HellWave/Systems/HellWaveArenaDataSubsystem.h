@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveArenaDataSubsystem.generated.h"
+
+class UHellWaveArenaBakeData;
+
+/**
+ *  World subsystem that exposes the baked arena data for the current level
+ *  The arena bake volume registers its data asset when it begins play
+ */
+UCLASS()
+class HELLWAVE_API UHellWaveArenaDataSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Baked data for the loaded arena */
+	UPROPERTY()
+	TObjectPtr<UHellWaveArenaBakeData> BakeData;
+
+	/** Visibility queries made since the subsystem started */
+	int64 VisibilityQueries = 0;
+
+	/** Visibility queries the baked grid resolved without a trace */
+	int64 VisibilityQueriesCulled = 0;
+
+public:
+
+	/** Logs the visibility grid cull rate for the session */
+	virtual void Deinitialize() override;
+
+	/** Sets the baked data for the loaded arena */
+	void SetBakeData(UHellWaveArenaBakeData* InBakeData);
+
+	/** Clears the baked data if it matches the passed asset */
+	void ClearBakeData(UHellWaveArenaBakeData* InBakeData);
+
+	/** Returns the baked data for the loaded arena, if any */
+	UHellWaveArenaBakeData* GetBakeData() const { return BakeData; }
+
+	/**
+	 *  Consults the baked visibility grid before a visibility trace between two points
+	 *  Returns false if the bake guarantees the points can't see each other, so the trace can be skipped
+	 *  Returns true if a real trace is still needed
+	 */
+	bool ShouldTraceVisibility(const FVector& From, const FVector& To);
+
+	/** Returns the number of visibility queries and how many were culled by the bake */
+	void GetVisibilityQueryStats(int64& OutQueries, int64& OutCulled) const;
+};
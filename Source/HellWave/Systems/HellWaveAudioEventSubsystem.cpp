@@ -0,0 +1,212 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveAudioEventSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/PlayerController.h"
+#include "Sound/SoundBase.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Audio Event Flush"), STAT_HellWaveAudioFlush, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Events Posted"), STAT_HellWaveAudioEvents, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Events Collapsed"), STAT_HellWaveAudioEventsCollapsed, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Voices Started"), STAT_HellWaveAudioVoices, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Voices Skipped"), STAT_HellWaveAudioVoicesSkipped, STATGROUP_HellWave);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Pooled Voices"), STAT_HellWaveAudioPooledVoices, STATGROUP_HellWave);
+
+bool UHellWaveAudioEventSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveAudioEventSubsystem::Deinitialize()
+{
+	for (UAudioComponent* Voice : VoicePool)
+	{
+		if (IsValid(Voice))
+		{
+			Voice->Stop();
+			Voice->DestroyComponent();
+		}
+	}
+
+	VoicePool.Empty();
+	PendingEvents.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHellWaveAudioEventSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushEvents();
+}
+
+TStatId UHellWaveAudioEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHellWaveAudioEventSubsystem, STATGROUP_Tickables);
+}
+
+void UHellWaveAudioEventSubsystem::PostSoundEvent(USoundBase* Sound, USoundBase* CrowdSound, const FVector& Location, int32 Count)
+{
+	if (!Sound)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_HellWaveAudioEvents);
+
+	FSoundEventGroup& Group = PendingEvents.FindOrAdd(Sound);
+	Group.CrowdSound = CrowdSound ? CrowdSound : Sound;
+	Group.Events.Add({ Location, FMath::Max(1, Count), 0.0f });
+}
+
+void UHellWaveAudioEventSubsystem::FlushEvents()
+{
+	if (PendingEvents.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveAudioFlush);
+
+	// Components can be destroyed under us when their owner goes away
+	VoicePool.RemoveAllSwap([](const TObjectPtr<UAudioComponent>& Voice) { return !IsValid(Voice); });
+
+	// Everything is ranked by distance to the local listener
+	FVector ListenerLocation = FVector::ZeroVector;
+	if (APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		FVector ListenerFront, ListenerRight;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, ListenerFront, ListenerRight);
+	}
+
+	const float MaxDistanceSq = CrowdBandDistances.Num() > 0 ? FMath::Square(CrowdBandDistances.Last()) : TNumericLimits<float>::Max();
+
+	int32 VoicesStarted = 0;
+	int32 VoicesSkipped = 0;
+
+	auto TryPlayVoice = [this, &VoicesStarted, &VoicesSkipped](USoundBase* Sound, const FVector& Location, float VolumeMultiplier)
+	{
+		if (VoicesStarted < MaxVoicesPerFrame && PlayVoice(Sound, Location, VolumeMultiplier))
+		{
+			++VoicesStarted;
+		}
+		else
+		{
+			++VoicesSkipped;
+		}
+	};
+
+	// Per band shot count and count weighted location sum, reused across groups
+	TArray<int32, TInlineAllocator<4>> BandCounts;
+	TArray<FVector, TInlineAllocator<4>> BandLocations;
+
+	for (TPair<USoundBase*, FSoundEventGroup>& Pair : PendingEvents)
+	{
+		FSoundEventGroup& Group = Pair.Value;
+
+		for (FSoundEvent& Event : Group.Events)
+		{
+			Event.DistanceSq = FVector::DistSquared(Event.Location, ListenerLocation);
+		}
+
+		Group.Events.Sort([](const FSoundEvent& A, const FSoundEvent& B) { return A.DistanceSq < B.DistanceSq; });
+
+		BandCounts.Reset();
+		BandCounts.SetNumZeroed(CrowdBandDistances.Num());
+		BandLocations.Reset();
+		BandLocations.SetNumZeroed(CrowdBandDistances.Num());
+
+		int32 BandIndex = 0;
+
+		for (int32 EventIndex = 0; EventIndex < Group.Events.Num(); ++EventIndex)
+		{
+			const FSoundEvent& Event = Group.Events[EventIndex];
+
+			// Past the last band the shot can't be heard over the rest
+			if (Event.DistanceSq > MaxDistanceSq)
+			{
+				VoicesSkipped += Group.Events.Num() - EventIndex;
+				break;
+			}
+
+			// The closest shots keep their own voice
+			if (EventIndex < MaxIndividualVoices)
+			{
+				TryPlayVoice(Pair.Key, Event.Location, 1.0f);
+				continue;
+			}
+
+			// Without crowd bands, shots past the individual voices are dropped
+			if (CrowdBandDistances.Num() == 0)
+			{
+				VoicesSkipped += Group.Events.Num() - EventIndex;
+				break;
+			}
+
+			// Events are sorted, so the band only moves outwards
+			while (Event.DistanceSq > FMath::Square(CrowdBandDistances[BandIndex]))
+			{
+				++BandIndex;
+			}
+
+			BandCounts[BandIndex] += Event.Count;
+			BandLocations[BandIndex] += Event.Location * Event.Count;
+
+			INC_DWORD_STAT(STAT_HellWaveAudioEventsCollapsed);
+		}
+
+		// One layered voice per band, louder the more shots it stands for
+		for (int32 Band = 0; Band < BandCounts.Num(); ++Band)
+		{
+			const int32 Count = BandCounts[Band];
+			if (Count == 0)
+			{
+				continue;
+			}
+
+			const float Volume = FMath::Min(1.0f + FMath::Log2(static_cast<float>(Count)) * CrowdVolumePerDoubling, MaxCrowdVolume);
+			TryPlayVoice(Group.CrowdSound, BandLocations[Band] / Count, Volume);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_HellWaveAudioVoices, VoicesStarted);
+	INC_DWORD_STAT_BY(STAT_HellWaveAudioVoicesSkipped, VoicesSkipped);
+	SET_DWORD_STAT(STAT_HellWaveAudioPooledVoices, VoicePool.Num());
+
+	PendingEvents.Reset();
+}
+
+bool UHellWaveAudioEventSubsystem::PlayVoice(USoundBase* Sound, const FVector& Location, float VolumeMultiplier)
+{
+	// Reuse a component that finished playing
+	for (UAudioComponent* Voice : VoicePool)
+	{
+		if (!Voice->IsPlaying())
+		{
+			Voice->SetSound(Sound);
+			Voice->SetWorldLocation(Location);
+			Voice->SetVolumeMultiplier(VolumeMultiplier);
+			Voice->Play();
+			return true;
+		}
+	}
+
+	// Grow the pool until it reaches the voice budget
+	if (VoicePool.Num() >= MaxPooledVoices)
+	{
+		return false;
+	}
+
+	UAudioComponent* Voice = UGameplayStatics::SpawnSoundAtLocation(GetWorld(), Sound, Location, FRotator::ZeroRotator, VolumeMultiplier, 1.0f, 0.0f, nullptr, nullptr, false);
+	if (!Voice)
+	{
+		return false;
+	}
+
+	VoicePool.Add(Voice);
+	return true;
+}
@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveAudioEventSubsystem.generated.h"
+
+class USoundBase;
+class UAudioComponent;
+
+/**
+ *  Audio event layer for gunfire and other mass one-shot sounds
+ *  Sound events are gathered for a frame and grouped by sound
+ *  The closest events in each group play as individual voices, and the rest collapse into
+ *  one layered crowd voice per distance band, louder the more shots it stands in for
+ *  Voices play on pooled audio components
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UHellWaveAudioEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Closest events of the same sound played as individual voices each frame */
+	UPROPERTY(Config)
+	int32 MaxIndividualVoices = 3;
+
+	/** Upper distance of each crowd band, nearest first. Events past the last band are skipped */
+	UPROPERTY(Config)
+	TArray<float> CrowdBandDistances = { 1500.0f, 4000.0f, 10000.0f };
+
+	/** Crowd voice volume gained each time the number of collapsed shots doubles */
+	UPROPERTY(Config)
+	float CrowdVolumePerDoubling = 0.25f;
+
+	/** Maximum crowd voice volume multiplier */
+	UPROPERTY(Config)
+	float MaxCrowdVolume = 2.0f;
+
+	/** Maximum voices started per frame across every sound */
+	UPROPERTY(Config)
+	int32 MaxVoicesPerFrame = 12;
+
+	/** Maximum number of pooled audio components. Voices are skipped when they're all playing */
+	UPROPERTY(Config)
+	int32 MaxPooledVoices = 32;
+
+	/** Pooled audio components */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> VoicePool;
+
+	/** A sound event waiting for the end of frame flush */
+	struct FSoundEvent
+	{
+		FVector Location;
+
+		/** Number of shots this event stands for */
+		int32 Count;
+
+		/** Squared distance to the listener, filled on flush */
+		float DistanceSq;
+	};
+
+	/** Events posted this frame for one sound */
+	struct FSoundEventGroup
+	{
+		/** Sound used for crowd voices. Falls back to the event sound if unset */
+		USoundBase* CrowdSound = nullptr;
+
+		TArray<FSoundEvent> Events;
+	};
+
+	/** Events posted this frame, grouped by sound */
+	TMap<USoundBase*, FSoundEventGroup> PendingEvents;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Deinitialize() override;
+
+	/** Plays the voices for the events posted this frame */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *  Posts a sound event at a location, standing for Count shots
+	 *  Collapsed events play the crowd sound, or the event sound if no crowd sound is given
+	 */
+	void PostSoundEvent(USoundBase* Sound, USoundBase* CrowdSound, const FVector& Location, int32 Count = 1);
+
+protected:
+
+	/** Collapses and plays the pending events within the voice budgets */
+	void FlushEvents();
+
+	/** Plays a sound on a pooled audio component. Returns false if no component was free */
+	bool PlayVoice(USoundBase* Sound, const FVector& Location, float VolumeMultiplier);
+};
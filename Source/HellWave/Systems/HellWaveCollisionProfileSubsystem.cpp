@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveCollisionProfileSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+namespace
+{
+	const FName PropProfileName(TEXT("HellWaveProp"));
+	const FName DecorationProfileName(TEXT("HellWaveDecoration"));
+}
+
+bool UHellWaveCollisionProfileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveCollisionProfileSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	int32 NumProps = 0;
+	int32 NumDecorations = 0;
+
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		TInlineComponentArray<UStaticMeshComponent*> MeshComponents(*It);
+
+		for (UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			const FName Profile = FindProfileOverride(MeshComponent);
+			if (Profile.IsNone())
+			{
+				continue;
+			}
+
+			MeshComponent->SetCollisionProfileName(Profile);
+
+			if (Profile == PropProfileName)
+			{
+				++NumProps;
+			}
+			else
+			{
+				++NumDecorations;
+			}
+		}
+	}
+
+	UE_LOG(LogHellWave, Log, TEXT("%s: %d props and %d decorations moved to their collision profiles."), *InWorld.GetName(), NumProps, NumDecorations);
+}
+
+FName UHellWaveCollisionProfileSubsystem::FindProfileOverride(const UPrimitiveComponent* Component)
+{
+	const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component);
+	if (!MeshComponent || !MeshComponent->GetStaticMesh())
+	{
+		return NAME_None;
+	}
+
+	// Anything already moved off the engine's catch-all blocking profiles was set up on purpose
+	const FName CurrentProfile = MeshComponent->GetCollisionProfileName();
+	if (CurrentProfile != UCollisionProfile::BlockAll_ProfileName && CurrentProfile != UCollisionProfile::BlockAllDynamic_ProfileName)
+	{
+		return NAME_None;
+	}
+
+	const UHellWaveCollisionProfileSubsystem* Settings = GetDefault<UHellWaveCollisionProfileSubsystem>();
+	const TSoftObjectPtr<UStaticMesh> Mesh(MeshComponent->GetStaticMesh());
+
+	if (Settings->PropMeshes.Contains(Mesh))
+	{
+		return PropProfileName;
+	}
+
+	if (Settings->DecorationMeshes.Contains(Mesh))
+	{
+		return DecorationProfileName;
+	}
+
+	return NAME_None;
+}
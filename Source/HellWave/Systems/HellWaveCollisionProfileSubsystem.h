@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveCollisionProfileSubsystem.generated.h"
+
+class UPrimitiveComponent;
+class UStaticMesh;
+
+/**
+ *  Moves level props and decorations onto the HellWaveProp and HellWaveDecoration collision profiles when play begins
+ *  Meshes are picked by static mesh asset, so placed instances in every map switch over without resaving the maps
+ *  Only components still on an engine default blocking profile are changed, so hand-tuned collision is kept
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UHellWaveCollisionProfileSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Meshes that block movement, weapons and sight. Use the HellWaveProp profile */
+	UPROPERTY(Config)
+	TArray<TSoftObjectPtr<UStaticMesh>> PropMeshes;
+
+	/** Set dressing that only blocks movement. Use the HellWaveDecoration profile */
+	UPROPERTY(Config)
+	TArray<TSoftObjectPtr<UStaticMesh>> DecorationMeshes;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Switches the level's props and decorations to their profiles before any gameplay trace runs */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the profile a component is switched to at runtime, or NAME_None if it keeps its own. Lets editor bakes see runtime collision */
+	static FName FindProfileOverride(const UPrimitiveComponent* Component);
+};
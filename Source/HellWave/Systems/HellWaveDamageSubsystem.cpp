@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveDamageSubsystem.h"
+#include "HellWaveTeamComponent.h"
+#include "HellWaveFinisherDamageType.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/DamageType.h"
+#include "Engine/DamageEvents.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Resolve"), STAT_HellWaveDamageResolve, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Queued"), STAT_HellWaveDamageEvents, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Ignored"), STAT_HellWaveDamageEventsIgnored, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Targets Resolved"), STAT_HellWaveDamageTargets, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Deaths"), STAT_HellWaveDamageDeaths, STATGROUP_HellWave);
+
+bool UHellWaveDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveDamageSubsystem::Deinitialize()
+{
+	PendingDamage.Empty();
+	ResolvingDamage.Empty();
+	TargetDamage.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHellWaveDamageSubsystem::QueueDamage(AActor* Target, float Damage, AController* Instigator, AActor* Causer, TSubclassOf<UDamageType> DamageType)
+{
+	if (Damage == 0.0f)
+	{
+		return;
+	}
+
+	EnqueueDamage(Target, Damage, Instigator, Causer, DamageType);
+}
+
+void UHellWaveDamageSubsystem::QueueFinisher(AActor* Target, AController* Instigator, AActor* Causer, TSubclassOf<UHellWaveFinisherDamageType> FinisherType)
+{
+	if (!FinisherType)
+	{
+		return;
+	}
+
+	// Finishers ignore the amount, they kill outright
+	EnqueueDamage(Target, 0.0f, Instigator, Causer, FinisherType);
+}
+
+void UHellWaveDamageSubsystem::EnqueueDamage(AActor* Target, float Damage, AController* Instigator, AActor* Causer, TSubclassOf<UDamageType> DamageType)
+{
+	if (!IsValid(Target))
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_HellWaveDamageEvents);
+
+	// Projectiles are usually destroyed on impact, so remember who fired them while we still can
+	APawn* InstigatorPawn = Instigator ? Instigator->GetPawn() : nullptr;
+	if (!InstigatorPawn && Causer)
+	{
+		InstigatorPawn = Causer->GetInstigator();
+	}
+
+	PendingDamage.Add({ Target, Instigator, Causer, InstigatorPawn, DamageType ? DamageType : TSubclassOf<UDamageType>(UDamageType::StaticClass()), Damage });
+}
+
+void UHellWaveDamageSubsystem::ResolveDamage()
+{
+	if (PendingDamage.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveDamageResolve);
+
+	// Damage dealt by deaths during the pass is queued for next frame
+	Swap(PendingDamage, ResolvingDamage);
+
+	// Sum per actor and damage type, dropping friendly fire per event
+	TargetDamage.Reset();
+
+	for (const FQueuedDamage& Queued : ResolvingDamage)
+	{
+		AActor* Target = Queued.Target.Get();
+		if (!Target)
+		{
+			continue;
+		}
+
+		AController* Instigator = Queued.Instigator.Get();
+		APawn* InstigatorPawn = Queued.InstigatorPawn.Get();
+
+		// A destroyed causer is credited to the pawn that fired it
+		AActor* Causer = Queued.Causer.Get();
+		if (!Causer)
+		{
+			Causer = InstigatorPawn;
+		}
+
+		if (const UHellWaveTeamComponent* Team = UHellWaveTeamComponent::FindTeamComponent(Target))
+		{
+			if (Team->IsDead() || Team->ShouldIgnoreDamageFrom(InstigatorPawn ? InstigatorPawn : Causer))
+			{
+				INC_DWORD_STAT(STAT_HellWaveDamageEventsIgnored);
+				continue;
+			}
+		}
+
+		FTargetDamage* Summed = TargetDamage.FindByPredicate([Target, &Queued](const FTargetDamage& Entry)
+		{
+			return Entry.Target == Target && Entry.DamageType == Queued.DamageType;
+		});
+
+		if (!Summed)
+		{
+			Summed = &TargetDamage.Add_GetRef({ Target, Instigator, Causer, Queued.DamageType, 0.0f });
+		}
+
+		// The last hit gets the credit for the kill
+		Summed->Damage += Queued.Damage;
+		Summed->Instigator = Instigator ? Instigator : Summed->Instigator;
+		Summed->Causer = Causer ? Causer : Summed->Causer;
+	}
+
+	ResolvingDamage.Reset();
+
+	// One TakeDamage per actor runs armor, HP, death and score in order, so each actor can only die once
+	for (const FTargetDamage& Summed : TargetDamage)
+	{
+		if (!IsValid(Summed.Target))
+		{
+			continue;
+		}
+
+		const UHellWaveTeamComponent* Team = UHellWaveTeamComponent::FindTeamComponent(Summed.Target);
+		const bool bWasAlive = !Team || !Team->IsDead();
+
+		if (const UHellWaveFinisherDamageType* Finisher = Cast<UHellWaveFinisherDamageType>(Summed.DamageType->GetDefaultObject()))
+		{
+			// Earlier hits in this pass may have killed the actor already
+			if (bWasAlive)
+			{
+				Finisher->ApplyFinisher(Summed.Target, Summed.Instigator, Summed.Causer);
+			}
+		}
+		else
+		{
+			Summed.Target->TakeDamage(Summed.Damage, FDamageEvent(Summed.DamageType), Summed.Instigator, Summed.Causer);
+		}
+
+		INC_DWORD_STAT(STAT_HellWaveDamageTargets);
+
+		if (bWasAlive && Team && Team->IsDead())
+		{
+			INC_DWORD_STAT(STAT_HellWaveDamageDeaths);
+		}
+	}
+
+	TargetDamage.Reset();
+
+	// Push the kills from this pass to the UI in one update
+	OnDamageResolved.Broadcast();
+}
@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveDamageSubsystem.generated.h"
+
+class AController;
+class APawn;
+class UDamageType;
+class UHellWaveFinisherDamageType;
+
+/** Broadcast after every end of frame damage pass that delivered damage */
+DECLARE_MULTICAST_DELEGATE(FHellWaveDamageResolvedDelegate);
+
+/**
+ *  Collects damage dealt during the frame and resolves it in one pass at the end of the same frame,
+ *  run by UHellWaveEndOfFrameSubsystem after every actor and tickable object has ticked
+ *  Damage to the same actor with the same damage type is summed and delivered through a single TakeDamage call,
+ *  so armor, HP and death run once per actor per frame
+ *  Finishers such as glory kills are queued with the rest and resolved in hit order, so an actor can only die once
+ *  Listeners to OnDamageResolved, like the game mode's score UI, update once per pass
+ */
+UCLASS()
+class HELLWAVE_API UHellWaveDamageSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A damage event waiting for the end of frame pass */
+	struct FQueuedDamage
+	{
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<AController> Instigator;
+		TWeakObjectPtr<AActor> Causer;
+
+		/** Pawn behind the damage, captured on queue. Stands in for causers destroyed before the pass, like projectiles */
+		TWeakObjectPtr<APawn> InstigatorPawn;
+
+		TSubclassOf<UDamageType> DamageType;
+		float Damage;
+	};
+
+	/** Damage queued this frame, in the order it was dealt */
+	TArray<FQueuedDamage> PendingDamage;
+
+	/** Damage being resolved. Damage dealt while resolving waits for the next frame */
+	TArray<FQueuedDamage> ResolvingDamage;
+
+	/** Summed damage for one actor and damage type */
+	struct FTargetDamage
+	{
+		AActor* Target;
+		AController* Instigator;
+		AActor* Causer;
+		TSubclassOf<UDamageType> DamageType;
+		float Damage;
+	};
+
+	/** Damage summed per actor and damage type, in the order each actor was first hit */
+	TArray<FTargetDamage> TargetDamage;
+
+public:
+
+	/** Broadcast after each pass that delivered damage */
+	FHellWaveDamageResolvedDelegate OnDamageResolved;
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops any damage still queued */
+	virtual void Deinitialize() override;
+
+	/** Queues damage to an actor. Same arguments as UGameplayStatics::ApplyDamage */
+	void QueueDamage(AActor* Target, float Damage, AController* Instigator, AActor* Causer, TSubclassOf<UDamageType> DamageType);
+
+	/** Queues a finisher that kills the actor through the damage type instead of TakeDamage */
+	void QueueFinisher(AActor* Target, AController* Instigator, AActor* Causer, TSubclassOf<UHellWaveFinisherDamageType> FinisherType);
+
+	/** Sums the queued damage per actor and delivers it, then notifies OnDamageResolved. Run by the end of frame subsystem */
+	void ResolveDamage();
+
+protected:
+
+	/** Adds an event to the queue */
+	void EnqueueDamage(AActor* Target, float Damage, AController* Instigator, AActor* Causer, TSubclassOf<UDamageType> DamageType);
+};
@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveEndOfFrameSubsystem.h"
+#include "HellWaveStatusEffectSubsystem.h"
+#include "HellWaveDamageSubsystem.h"
+#include "HellWaveImpulseSubsystem.h"
+#include "HellWaveNoiseSubsystem.h"
+#include "Engine/World.h"
+
+bool UHellWaveEndOfFrameSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveEndOfFrameSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	// Every system the pass flushes exists before the first frame ends
+	Collection.InitializeDependency<UHellWaveStatusEffectSubsystem>();
+	Collection.InitializeDependency<UHellWaveDamageSubsystem>();
+	Collection.InitializeDependency<UHellWaveImpulseSubsystem>();
+	Collection.InitializeDependency<UHellWaveNoiseSubsystem>();
+
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UHellWaveEndOfFrameSubsystem::OnWorldPostActorTick);
+}
+
+void UHellWaveEndOfFrameSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Super::Deinitialize();
+}
+
+void UHellWaveEndOfFrameSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	// Only our world, and nothing moves while paused
+	if (InWorld != GetWorld() || InWorld->IsPaused())
+	{
+		return;
+	}
+
+	// 1. Damage over time joins the hits dealt this frame
+	if (UHellWaveStatusEffectSubsystem* StatusEffects = InWorld->GetSubsystem<UHellWaveStatusEffectSubsystem>())
+	{
+		StatusEffects->UpdateEffects(DeltaTime);
+	}
+
+	// 2. Armor, HP, finishers, deaths and score
+	if (UHellWaveDamageSubsystem* DamageSubsystem = InWorld->GetSubsystem<UHellWaveDamageSubsystem>())
+	{
+		DamageSubsystem->ResolveDamage();
+	}
+
+	// 3. Deaths from this pass turned on ragdolls, so the hits that caused them can push the bodies
+	if (UHellWaveImpulseSubsystem* ImpulseSubsystem = InWorld->GetSubsystem<UHellWaveImpulseSubsystem>())
+	{
+		ImpulseSubsystem->Flush();
+	}
+
+	// 4. AI hears the frame's noises
+	if (UHellWaveNoiseSubsystem* NoiseSubsystem = InWorld->GetSubsystem<UHellWaveNoiseSubsystem>())
+	{
+		NoiseSubsystem->FlushNoises();
+	}
+}
@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveEndOfFrameSubsystem.generated.h"
+
+/**
+ *  Runs the batched gameplay systems at the end of the frame, after every actor and tickable object has ticked,
+ *  in a fixed order:
+ *  status effects queue their damage, damage resolves, impulses flush onto any ragdolls it started,
+ *  then noises are delivered
+ *  The systems themselves only queue and flush, so the order lives in one place
+ */
+UCLASS()
+class HELLWAVE_API UHellWaveEndOfFrameSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Handle for the end of world tick callback */
+	FDelegateHandle PostActorTickHandle;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Hooks the end of frame pass into the world tick */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Unhooks the end of frame pass */
+	virtual void Deinitialize() override;
+
+protected:
+
+	/** Runs the end of frame pass once every actor and tickable object has ticked */
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+};
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/DamageType.h"
+#include "HellWaveFinisherDamageType.generated.h"
+
+class AController;
+
+/**
+ *  Damage type for finishers that kill outright with their own reaction, like glory kills
+ *  Queued through UHellWaveDamageSubsystem::QueueFinisher and resolved in the same pass as other damage,
+ *  which calls ApplyFinisher instead of TakeDamage on actors still alive when their turn comes
+ */
+UCLASS(abstract, const)
+class HELLWAVE_API UHellWaveFinisherDamageType : public UDamageType
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Kills the target with the finisher's reaction. Called on the class default object */
+	virtual void ApplyFinisher(AActor* Target, AController* Instigator, AActor* Causer) const PURE_VIRTUAL(UHellWaveFinisherDamageType::ApplyFinisher, );
+};
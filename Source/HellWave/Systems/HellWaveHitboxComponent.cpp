@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveHitboxComponent.h"
+#include "HellWaveHitboxSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+UHellWaveHitboxComponent::UHellWaveHitboxComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Capsule set for the UE5 mannequin
+	auto AddHitbox = [this](const TCHAR* StartBone, const TCHAR* EndBone, float Radius, EHellWaveHitZone Zone, float DamageMultiplier)
+	{
+		FHellWaveHitboxDefinition& Hitbox = Hitboxes.AddDefaulted_GetRef();
+		Hitbox.StartBone = StartBone;
+		Hitbox.EndBone = EndBone;
+		Hitbox.Radius = Radius;
+		Hitbox.Zone = Zone;
+		Hitbox.DamageMultiplier = DamageMultiplier;
+	};
+
+	AddHitbox(TEXT("neck_01"), TEXT("head"), 12.0f, EHellWaveHitZone::Head, 2.0f);
+	AddHitbox(TEXT("pelvis"), TEXT("spine_05"), 20.0f, EHellWaveHitZone::Torso, 1.0f);
+	AddHitbox(TEXT("upperarm_l"), TEXT("lowerarm_l"), 7.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("lowerarm_l"), TEXT("hand_l"), 6.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("upperarm_r"), TEXT("lowerarm_r"), 7.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("lowerarm_r"), TEXT("hand_r"), 6.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("thigh_l"), TEXT("calf_l"), 10.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("calf_l"), TEXT("foot_l"), 8.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("thigh_r"), TEXT("calf_r"), 10.0f, EHellWaveHitZone::Limb, 0.75f);
+	AddHitbox(TEXT("calf_r"), TEXT("foot_r"), 8.0f, EHellWaveHitZone::Limb, 0.75f);
+}
+
+void UHellWaveHitboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Follow the character mesh, or the first skeletal mesh on the owner
+	if (const ACharacter* Character = Cast<ACharacter>(GetOwner()))
+	{
+		Mesh = Character->GetMesh();
+	}
+	else
+	{
+		Mesh = GetOwner()->FindComponentByClass<USkeletalMeshComponent>();
+	}
+
+	if (!Mesh)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("Hitbox component on %s has no skeletal mesh to follow"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	MeshHitscanResponse = Mesh->GetCollisionResponseToChannel(ECC_HellWaveHitscan);
+
+	// Resolve bone names once so the per frame refresh is a straight index lookup
+	BoneIndices.SetNumUninitialized(Hitboxes.Num() * 2);
+
+	for (int32 HitboxIndex = 0; HitboxIndex < Hitboxes.Num(); ++HitboxIndex)
+	{
+		const FHellWaveHitboxDefinition& Hitbox = Hitboxes[HitboxIndex];
+		const int32 StartIndex = Mesh->GetBoneIndex(Hitbox.StartBone);
+		const int32 EndIndex = Hitbox.EndBone.IsNone() ? StartIndex : Mesh->GetBoneIndex(Hitbox.EndBone);
+
+		if (StartIndex == INDEX_NONE || EndIndex == INDEX_NONE)
+		{
+			UE_LOG(LogHellWave, Warning, TEXT("Hitbox %s-%s not found on %s"), *Hitbox.StartBone.ToString(), *Hitbox.EndBone.ToString(), *GetNameSafe(GetOwner()));
+		}
+
+		BoneIndices[HitboxIndex * 2] = StartIndex;
+		BoneIndices[HitboxIndex * 2 + 1] = EndIndex;
+	}
+
+	if (UHellWaveHitboxSubsystem* Subsystem = GetWorld()->GetSubsystem<UHellWaveHitboxSubsystem>())
+	{
+		Subsystem->RegisterHitboxes(this);
+	}
+}
+
+void UHellWaveHitboxComponent::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	if (UHellWaveHitboxSubsystem* Subsystem = GetWorld()->GetSubsystem<UHellWaveHitboxSubsystem>())
+	{
+		Subsystem->UnregisterHitboxes(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UHellWaveHitboxComponent::AreHitboxesActive() const
+{
+	return Mesh && Mesh->IsRegistered() && !Mesh->IsSimulatingPhysics();
+}
+
+void UHellWaveHitboxComponent::ApplyHitscanResponse(bool bHitboxTracing)
+{
+	if (Mesh)
+	{
+		Mesh->SetCollisionResponseToChannel(ECC_HellWaveHitscan, bHitboxTracing ? ECR_Ignore : MeshHitscanResponse.GetValue());
+	}
+}
+
+bool UHellWaveHitboxComponent::GetHitboxSegment(int32 HitboxIndex, FVector& OutStart, FVector& OutEnd) const
+{
+	const int32 StartIndex = BoneIndices[HitboxIndex * 2];
+	const int32 EndIndex = BoneIndices[HitboxIndex * 2 + 1];
+
+	if (StartIndex == INDEX_NONE || EndIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutStart = Mesh->GetBoneTransform(StartIndex).GetLocation();
+	OutEnd = (EndIndex == StartIndex) ? OutStart : Mesh->GetBoneTransform(EndIndex).GetLocation();
+	return true;
+}
@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HellWaveHitboxComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+/** Body zone a hitbox belongs to. Drives zone damage */
+UENUM(BlueprintType)
+enum class EHellWaveHitZone : uint8
+{
+	Head,
+	Torso,
+	Limb
+};
+
+/** A capsule hitbox swept between two bones */
+USTRUCT(BlueprintType)
+struct FHellWaveHitboxDefinition
+{
+	GENERATED_BODY()
+
+	/** Bone at the start of the capsule segment */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hitbox")
+	FName StartBone;
+
+	/** Bone at the end of the capsule segment. If none, the capsule is a sphere around the start bone */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hitbox")
+	FName EndBone;
+
+	/** Capsule radius */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hitbox", meta = (ClampMin = 1, ClampMax = 100, Units = "cm"))
+	float Radius = 10.0f;
+
+	/** Body zone hit by this capsule */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hitbox")
+	EHellWaveHitZone Zone = EHellWaveHitZone::Torso;
+
+	/** Multiplier applied to hitscan damage for hits on this capsule */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hitbox", meta = (ClampMin = 0, ClampMax = 10))
+	float DamageMultiplier = 1.0f;
+};
+
+/**
+ *  Publishes analytic hitbox capsules for its owner's skeletal mesh
+ *  Hitscan weapons test rays against these capsules instead of tracing the physics asset,
+ *  so the mesh ignores the hitscan channel while the capsules are in use
+ *  The hitbox subsystem refreshes the capsules from the bone transforms once per frame
+ *  Defaults match the UE5 mannequin skeleton
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class HELLWAVE_API UHellWaveHitboxComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Hitbox capsules published for the owner */
+	UPROPERTY(EditAnywhere, Category="Hitbox")
+	TArray<FHellWaveHitboxDefinition> Hitboxes;
+
+	/** Mesh the hitboxes follow. Defaults to the owning character's mesh */
+	UPROPERTY(Transient)
+	TObjectPtr<USkeletalMeshComponent> Mesh;
+
+	/** Start and end bone indices for each hitbox, resolved on BeginPlay */
+	TArray<int32> BoneIndices;
+
+	/** The mesh's own hitscan response, restored when hitbox tracing is turned off */
+	TEnumAsByte<ECollisionResponse> MeshHitscanResponse = ECR_Block;
+
+public:
+
+	UHellWaveHitboxComponent();
+
+protected:
+
+	/** Resolves the bones and registers with the hitbox subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters from the hitbox subsystem */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+	/** Returns the hitbox definitions */
+	const TArray<FHellWaveHitboxDefinition>& GetHitboxes() const { return Hitboxes; }
+
+	/** Returns the mesh the hitboxes follow */
+	USkeletalMeshComponent* GetMesh() const { return Mesh; }
+
+	/** Returns true if the hitboxes should be tested this frame. Ragdolled meshes are left to the physics scene */
+	bool AreHitboxesActive() const;
+
+	/** Takes the mesh off the hitscan channel while its hitboxes are traced, or restores its response */
+	void ApplyHitscanResponse(bool bHitboxTracing);
+
+	/** Writes the world space segment for a hitbox. Returns false if its bones couldn't be resolved */
+	bool GetHitboxSegment(int32 HitboxIndex, FVector& OutStart, FVector& OutEnd) const;
+};
@@ -0,0 +1,383 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveHitboxSubsystem.h"
+#include "HellWaveHitboxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox Refresh"), STAT_HellWaveHitboxRefresh, STATGROUP_HellWave);
+DECLARE_CYCLE_STAT(TEXT("Hitbox Query"), STAT_HellWaveHitboxQuery, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitbox Capsules"), STAT_HellWaveHitboxCapsules, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitbox Queries"), STAT_HellWaveHitboxQueries, STATGROUP_HellWave);
+
+static TAutoConsoleVariable<bool> CVarHitscanHitboxes(
+	TEXT("HellWave.HitscanHitboxes"),
+	true,
+	TEXT("If true, hitscan pellets test the packed hitbox capsules and only trace world geometry.\n")
+	TEXT("If false, pellets trace the enemy meshes. Compare with \"stat HellWave\" (Hitscan Pellet)."),
+	ECVF_Default);
+
+namespace
+{
+	/** Capsules tested per kernel step */
+	constexpr int32 CapsuleLanes = 4;
+
+	/** Clamps each lane to [0, 1] */
+	FORCEINLINE VectorRegister4Float VectorClamp01(const VectorRegister4Float& Value)
+	{
+		return VectorMin(VectorMax(Value, VectorZeroFloat()), VectorOneFloat());
+	}
+
+	/** Three component dot product across four lanes of SoA vectors */
+	FORCEINLINE VectorRegister4Float VectorDot3SoA(
+		const VectorRegister4Float& AX, const VectorRegister4Float& AY, const VectorRegister4Float& AZ,
+		const VectorRegister4Float& BX, const VectorRegister4Float& BY, const VectorRegister4Float& BZ)
+	{
+		return VectorMultiplyAdd(AZ, BZ, VectorMultiplyAdd(AY, BY, VectorMultiply(AX, BX)));
+	}
+}
+
+bool UHellWaveHitboxSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveHitboxSubsystem::Deinitialize()
+{
+	HitboxBlocks.Empty();
+	ResizeCapsules(0);
+
+	Super::Deinitialize();
+}
+
+void UHellWaveHitboxSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Hand the meshes back to the hitscan channel, or take them off it, when the toggle changes
+	const bool bHitboxTracing = IsHitboxTracingEnabled();
+	if (bHitboxTracing != bHitboxTracingApplied)
+	{
+		bHitboxTracingApplied = bHitboxTracing;
+
+		for (const FHitboxBlock& Block : HitboxBlocks)
+		{
+			if (UHellWaveHitboxComponent* Component = Block.Component.Get())
+			{
+				Component->ApplyHitscanResponse(bHitboxTracing);
+			}
+		}
+	}
+
+	RefreshCapsules();
+}
+
+TStatId UHellWaveHitboxSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHellWaveHitboxSubsystem, STATGROUP_Tickables);
+}
+
+void UHellWaveHitboxSubsystem::RegisterHitboxes(UHellWaveHitboxComponent* Component)
+{
+	if (!Component || HitboxBlocks.ContainsByPredicate([Component](const FHitboxBlock& Block) { return Block.Component == Component; }))
+	{
+		return;
+	}
+
+	// Claim a block at the end of the packed arrays
+	const FHitboxBlock& Block = HitboxBlocks.Add_GetRef({ Component, NumCapsules, Component->GetHitboxes().Num() });
+	const int32 BlockIndex = HitboxBlocks.Num() - 1;
+
+	ResizeCapsules(NumCapsules + Block.NumCapsules);
+
+	for (int32 HitboxIndex = 0; HitboxIndex < Block.NumCapsules; ++HitboxIndex)
+	{
+		const int32 CapsuleIndex = Block.FirstCapsule + HitboxIndex;
+		CapsuleComponents[CapsuleIndex] = BlockIndex;
+		CapsuleDefinitions[CapsuleIndex] = HitboxIndex;
+		CapsuleActors[CapsuleIndex] = Component->GetOwner();
+	}
+
+	Component->ApplyHitscanResponse(bHitboxTracingApplied);
+
+	// Hittable right away, not from the next tick
+	if (bHitboxTracingApplied)
+	{
+		NumActiveCapsules += UpdateBlock(Block);
+	}
+}
+
+void UHellWaveHitboxSubsystem::UnregisterHitboxes(UHellWaveHitboxComponent* Component)
+{
+	const int32 BlockIndex = HitboxBlocks.IndexOfByPredicate([Component](const FHitboxBlock& Block) { return Block.Component == Component; });
+
+	// Remove right away so no capsule outlives its owner
+	if (BlockIndex != INDEX_NONE)
+	{
+		RemoveBlock(BlockIndex);
+	}
+}
+
+void UHellWaveHitboxSubsystem::RefreshCapsules()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveHitboxRefresh);
+
+	// Drop components that were destroyed without ending play
+	for (int32 BlockIndex = HitboxBlocks.Num() - 1; BlockIndex >= 0; --BlockIndex)
+	{
+		if (!HitboxBlocks[BlockIndex].Component.IsValid())
+		{
+			RemoveBlock(BlockIndex);
+		}
+	}
+
+	NumActiveCapsules = 0;
+
+	for (int32 BlockIndex = 0; bHitboxTracingApplied && BlockIndex < HitboxBlocks.Num(); ++BlockIndex)
+	{
+		NumActiveCapsules += UpdateBlock(HitboxBlocks[BlockIndex]);
+	}
+
+	SET_DWORD_STAT(STAT_HellWaveHitboxCapsules, NumActiveCapsules);
+}
+
+int32 UHellWaveHitboxSubsystem::UpdateBlock(const FHitboxBlock& Block)
+{
+	const UHellWaveHitboxComponent* Component = Block.Component.Get();
+	const bool bActive = Component && Component->AreHitboxesActive();
+
+	int32 NumActive = 0;
+
+	for (int32 HitboxIndex = 0; HitboxIndex < Block.NumCapsules; ++HitboxIndex)
+	{
+		const int32 CapsuleIndex = Block.FirstCapsule + HitboxIndex;
+
+		// Ragdolled meshes and unresolved bones keep their slot but can't be hit
+		FVector SegmentStart, SegmentEnd;
+		if (!bActive || !Component->GetHitboxSegment(HitboxIndex, SegmentStart, SegmentEnd))
+		{
+			RadiusSq[CapsuleIndex] = -1.0f;
+			continue;
+		}
+
+		const FVector Axis = SegmentEnd - SegmentStart;
+
+		StartX[CapsuleIndex] = SegmentStart.X;
+		StartY[CapsuleIndex] = SegmentStart.Y;
+		StartZ[CapsuleIndex] = SegmentStart.Z;
+		AxisX[CapsuleIndex] = Axis.X;
+		AxisY[CapsuleIndex] = Axis.Y;
+		AxisZ[CapsuleIndex] = Axis.Z;
+		RadiusSq[CapsuleIndex] = FMath::Square(Component->GetHitboxes()[HitboxIndex].Radius);
+
+		++NumActive;
+	}
+
+	return NumActive;
+}
+
+void UHellWaveHitboxSubsystem::RemoveBlock(int32 BlockIndex)
+{
+	const FHitboxBlock Block = HitboxBlocks[BlockIndex];
+	HitboxBlocks.RemoveAt(BlockIndex);
+
+	for (int32 CapsuleIndex = Block.FirstCapsule; CapsuleIndex < Block.FirstCapsule + Block.NumCapsules; ++CapsuleIndex)
+	{
+		NumActiveCapsules -= RadiusSq[CapsuleIndex] >= 0.0f ? 1 : 0;
+	}
+
+	// Shift the later blocks down over the gap. The arrays keep their allocation
+	StartX.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	StartY.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	StartZ.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	AxisX.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	AxisY.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	AxisZ.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	RadiusSq.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	CapsuleComponents.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	CapsuleDefinitions.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+	CapsuleActors.RemoveAt(Block.FirstCapsule, Block.NumCapsules, EAllowShrinking::No);
+
+	for (int32 LaterIndex = BlockIndex; LaterIndex < HitboxBlocks.Num(); ++LaterIndex)
+	{
+		FHitboxBlock& LaterBlock = HitboxBlocks[LaterIndex];
+		LaterBlock.FirstCapsule -= Block.NumCapsules;
+
+		for (int32 CapsuleIndex = LaterBlock.FirstCapsule; CapsuleIndex < LaterBlock.FirstCapsule + LaterBlock.NumCapsules; ++CapsuleIndex)
+		{
+			CapsuleComponents[CapsuleIndex] = LaterIndex;
+		}
+	}
+
+	ResizeCapsules(NumCapsules - Block.NumCapsules);
+}
+
+void UHellWaveHitboxSubsystem::ResizeCapsules(int32 NewNumCapsules)
+{
+	const int32 OldNumPadded = RadiusSq.Num();
+
+	NumCapsules = NewNumCapsules;
+
+	// Pad to a whole kernel step with capsules that can't be hit
+	const int32 NumPadded = Align(NumCapsules, CapsuleLanes);
+
+	StartX.SetNumZeroed(NumPadded, EAllowShrinking::No);
+	StartY.SetNumZeroed(NumPadded, EAllowShrinking::No);
+	StartZ.SetNumZeroed(NumPadded, EAllowShrinking::No);
+	AxisX.SetNumZeroed(NumPadded, EAllowShrinking::No);
+	AxisY.SetNumZeroed(NumPadded, EAllowShrinking::No);
+	AxisZ.SetNumZeroed(NumPadded, EAllowShrinking::No);
+	RadiusSq.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	CapsuleComponents.SetNumZeroed(NumCapsules, EAllowShrinking::No);
+	CapsuleDefinitions.SetNumZeroed(NumCapsules, EAllowShrinking::No);
+	CapsuleActors.SetNumZeroed(NumCapsules, EAllowShrinking::No);
+
+	// New slots and the padding stay unhittable until a block writes them
+	for (int32 CapsuleIndex = FMath::Min(OldNumPadded, NumCapsules); CapsuleIndex < NumPadded; ++CapsuleIndex)
+	{
+		RadiusSq[CapsuleIndex] = -1.0f;
+	}
+}
+
+bool UHellWaveHitboxSubsystem::TraceHitboxes(const FVector& Start, const FVector& End, const AActor* IgnoreActor, FHellWaveHitboxHit& OutHit) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveHitboxQuery);
+	INC_DWORD_STAT(STAT_HellWaveHitboxQueries);
+
+	const FVector3f RayStart(Start);
+	const FVector3f Ray(End - Start);
+	const float RayLengthSq = Ray.SizeSquared();
+
+	if (NumActiveCapsules == 0 || RayLengthSq <= UE_KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const float RayLength = FMath::Sqrt(RayLengthSq);
+
+	// Ray terms shared by every capsule
+	const VectorRegister4Float RayStartX = VectorSetFloat1(RayStart.X);
+	const VectorRegister4Float RayStartY = VectorSetFloat1(RayStart.Y);
+	const VectorRegister4Float RayStartZ = VectorSetFloat1(RayStart.Z);
+	const VectorRegister4Float RayX = VectorSetFloat1(Ray.X);
+	const VectorRegister4Float RayY = VectorSetFloat1(Ray.Y);
+	const VectorRegister4Float RayZ = VectorSetFloat1(Ray.Z);
+	const VectorRegister4Float RayLenSq = VectorSetFloat1(RayLengthSq);
+	const VectorRegister4Float InvRayLenSq = VectorSetFloat1(1.0f / RayLengthSq);
+	const VectorRegister4Float Epsilon = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+
+	int32 BestCapsule = INDEX_NONE;
+	float BestDistance = TNumericLimits<float>::Max();
+	float BestAxisAlpha = 0.0f;
+
+	const int32 NumPadded = RadiusSq.Num();
+
+	for (int32 Base = 0; Base < NumPadded; Base += CapsuleLanes)
+	{
+		const VectorRegister4Float CapStartX = VectorLoad(&StartX[Base]);
+		const VectorRegister4Float CapStartY = VectorLoad(&StartY[Base]);
+		const VectorRegister4Float CapStartZ = VectorLoad(&StartZ[Base]);
+		const VectorRegister4Float CapAxisX = VectorLoad(&AxisX[Base]);
+		const VectorRegister4Float CapAxisY = VectorLoad(&AxisY[Base]);
+		const VectorRegister4Float CapAxisZ = VectorLoad(&AxisZ[Base]);
+		const VectorRegister4Float CapRadiusSq = VectorLoad(&RadiusSq[Base]);
+
+		// Closest points between the ray segment and each capsule segment
+		const VectorRegister4Float OffsetX = VectorSubtract(RayStartX, CapStartX);
+		const VectorRegister4Float OffsetY = VectorSubtract(RayStartY, CapStartY);
+		const VectorRegister4Float OffsetZ = VectorSubtract(RayStartZ, CapStartZ);
+
+		const VectorRegister4Float AxisLenSq = VectorDot3SoA(CapAxisX, CapAxisY, CapAxisZ, CapAxisX, CapAxisY, CapAxisZ);
+		const VectorRegister4Float AxisDotOffset = VectorDot3SoA(CapAxisX, CapAxisY, CapAxisZ, OffsetX, OffsetY, OffsetZ);
+		const VectorRegister4Float RayDotOffset = VectorDot3SoA(RayX, RayY, RayZ, OffsetX, OffsetY, OffsetZ);
+		const VectorRegister4Float RayDotAxis = VectorDot3SoA(RayX, RayY, RayZ, CapAxisX, CapAxisY, CapAxisZ);
+
+		// Unclamped ray parameter, then the capsule parameter for it, then the ray parameter again for the clamped capsule point
+		const VectorRegister4Float Denom = VectorSubtract(VectorMultiply(RayLenSq, AxisLenSq), VectorMultiply(RayDotAxis, RayDotAxis));
+		const VectorRegister4Float RayAlphaFree = VectorClamp01(VectorDivide(
+			VectorSubtract(VectorMultiply(RayDotAxis, AxisDotOffset), VectorMultiply(RayDotOffset, AxisLenSq)),
+			VectorMax(Denom, Epsilon)));
+		const VectorRegister4Float AxisAlpha = VectorClamp01(VectorDivide(
+			VectorMultiplyAdd(RayDotAxis, RayAlphaFree, AxisDotOffset),
+			VectorMax(AxisLenSq, Epsilon)));
+		const VectorRegister4Float RayAlpha = VectorClamp01(VectorMultiply(
+			VectorSubtract(VectorMultiply(RayDotAxis, AxisAlpha), RayDotOffset),
+			InvRayLenSq));
+
+		// Squared gap between the closest points
+		const VectorRegister4Float GapX = VectorSubtract(VectorMultiplyAdd(RayX, RayAlpha, OffsetX), VectorMultiply(CapAxisX, AxisAlpha));
+		const VectorRegister4Float GapY = VectorSubtract(VectorMultiplyAdd(RayY, RayAlpha, OffsetY), VectorMultiply(CapAxisY, AxisAlpha));
+		const VectorRegister4Float GapZ = VectorSubtract(VectorMultiplyAdd(RayZ, RayAlpha, OffsetZ), VectorMultiply(CapAxisZ, AxisAlpha));
+		const VectorRegister4Float GapSq = VectorDot3SoA(GapX, GapY, GapZ, GapX, GapY, GapZ);
+
+		const int32 HitMask = VectorMaskBits(VectorCompareLE(GapSq, CapRadiusSq));
+
+		if (HitMask == 0)
+		{
+			continue;
+		}
+
+		// Resolve the few lanes that hit in scalar
+		float LaneGapSq[CapsuleLanes];
+		float LaneRayAlpha[CapsuleLanes];
+		float LaneAxisAlpha[CapsuleLanes];
+		VectorStore(GapSq, LaneGapSq);
+		VectorStore(RayAlpha, LaneRayAlpha);
+		VectorStore(AxisAlpha, LaneAxisAlpha);
+
+		for (int32 Lane = 0; Lane < CapsuleLanes; ++Lane)
+		{
+			const int32 CapsuleIndex = Base + Lane;
+
+			if (!(HitMask & (1 << Lane)) || CapsuleActors[CapsuleIndex] == IgnoreActor)
+			{
+				continue;
+			}
+
+			// Back off from the closest approach to the capsule surface
+			const float EntryDistance = FMath::Max(0.0f, LaneRayAlpha[Lane] * RayLength - FMath::Sqrt(FMath::Max(0.0f, RadiusSq[CapsuleIndex] - LaneGapSq[Lane])));
+
+			if (EntryDistance < BestDistance)
+			{
+				BestCapsule = CapsuleIndex;
+				BestDistance = EntryDistance;
+				BestAxisAlpha = LaneAxisAlpha[Lane];
+			}
+		}
+	}
+
+	if (BestCapsule == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const UHellWaveHitboxComponent* Component = HitboxBlocks[CapsuleComponents[BestCapsule]].Component.Get();
+	if (!Component)
+	{
+		return false;
+	}
+
+	const FHellWaveHitboxDefinition& Hitbox = Component->GetHitboxes()[CapsuleDefinitions[BestCapsule]];
+
+	const FVector RayDirection = FVector(Ray) / RayLength;
+	const FVector AxisPoint = FVector(StartX[BestCapsule], StartY[BestCapsule], StartZ[BestCapsule])
+		+ FVector(AxisX[BestCapsule], AxisY[BestCapsule], AxisZ[BestCapsule]) * BestAxisAlpha;
+
+	OutHit.Actor = Component->GetOwner();
+	OutHit.Component = Component->GetMesh();
+	OutHit.BoneName = Hitbox.StartBone;
+	OutHit.Zone = Hitbox.Zone;
+	OutHit.DamageMultiplier = Hitbox.DamageMultiplier;
+	OutHit.Distance = BestDistance;
+	OutHit.Location = Start + RayDirection * BestDistance;
+	OutHit.Normal = (OutHit.Location - AxisPoint).GetSafeNormal(UE_SMALL_NUMBER, -RayDirection);
+
+	return true;
+}
+
+bool UHellWaveHitboxSubsystem::IsHitboxTracingEnabled()
+{
+	return CVarHitscanHitboxes.GetValueOnGameThread();
+}
@@ -0,0 +1,139 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveHitboxComponent.h"
+#include "HellWaveHitboxSubsystem.generated.h"
+
+class UPrimitiveComponent;
+
+/** Nearest hitbox capsule hit by a ray */
+struct FHellWaveHitboxHit
+{
+	/** Actor that owns the capsule */
+	AActor* Actor = nullptr;
+
+	/** Mesh the capsule follows */
+	UPrimitiveComponent* Component = nullptr;
+
+	/** Bone at the start of the capsule segment */
+	FName BoneName;
+
+	/** Body zone of the capsule */
+	EHellWaveHitZone Zone = EHellWaveHitZone::Torso;
+
+	/** Damage multiplier of the capsule */
+	float DamageMultiplier = 1.0f;
+
+	/** Distance from the ray start to the capsule surface */
+	float Distance = 0.0f;
+
+	/** Point where the ray enters the capsule */
+	FVector Location = FVector::ZeroVector;
+
+	/** Capsule surface normal at the entry point */
+	FVector Normal = FVector::ZeroVector;
+};
+
+/**
+ *  Packs every enemy's hitbox capsules into flat arrays and tests rays against them
+ *  Each registered component owns a fixed block of capsules, written in place from the bone transforms once per frame
+ *  Blocks are only moved when a component unregisters
+ *  Rays are tested four capsules at a time, so hitscan weapons only need the physics
+ *  scene for the world geometry occlusion distance
+ *  Meshes with hitboxes ignore the hitscan channel while hitbox tracing is enabled
+ */
+UCLASS()
+class HELLWAVE_API UHellWaveHitboxSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A registered component and the block of packed capsules it owns */
+	struct FHitboxBlock
+	{
+		TWeakObjectPtr<UHellWaveHitboxComponent> Component;
+		int32 FirstCapsule;
+		int32 NumCapsules;
+	};
+
+	/** Components publishing hitboxes, in capsule order */
+	TArray<FHitboxBlock> HitboxBlocks;
+
+	// Packed capsules, one entry per capsule, padded to a multiple of four
+	// Segments are stored as a start point and an axis to the end point
+
+	TArray<float> StartX;
+	TArray<float> StartY;
+	TArray<float> StartZ;
+	TArray<float> AxisX;
+	TArray<float> AxisY;
+	TArray<float> AxisZ;
+
+	/** Squared radius. Padding and inactive capsules are negative so they never hit */
+	TArray<float> RadiusSq;
+
+	/** Index into HitboxBlocks of each capsule's owner */
+	TArray<int32> CapsuleComponents;
+
+	/** Index into the owner's hitbox definitions of each capsule */
+	TArray<int32> CapsuleDefinitions;
+
+	/** Owning actor of each capsule, so the shooter can be skipped without a component lookup */
+	TArray<const AActor*> CapsuleActors;
+
+	/** Number of registered capsules, before padding */
+	int32 NumCapsules = 0;
+
+	/** Number of capsules that can be hit this frame */
+	int32 NumActiveCapsules = 0;
+
+	/** Hitbox tracing state last pushed to the registered meshes */
+	bool bHitboxTracingApplied = true;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Deinitialize() override;
+
+	/** Refreshes the packed capsules from the current bone transforms */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Adds a component's hitboxes to the packed set */
+	void RegisterHitboxes(UHellWaveHitboxComponent* Component);
+
+	/** Removes a component's hitboxes from the packed set */
+	void UnregisterHitboxes(UHellWaveHitboxComponent* Component);
+
+	/** Returns true if any capsules were published this frame */
+	bool HasHitboxes() const { return NumActiveCapsules > 0; }
+
+	/**
+	 *  Tests a ray segment against every packed capsule
+	 *  Capsules owned by the ignored actor are skipped
+	 *  Returns true and fills the nearest hit if any capsule was hit
+	 */
+	bool TraceHitboxes(const FVector& Start, const FVector& End, const AActor* IgnoreActor, FHellWaveHitboxHit& OutHit) const;
+
+	/** Returns true if hitscan weapons should test hitboxes instead of the meshes. Set with HellWave.HitscanHitboxes */
+	static bool IsHitboxTracingEnabled();
+
+protected:
+
+	/** Writes every block's capsules from the current bone transforms */
+	void RefreshCapsules();
+
+	/** Writes a block's capsules from the current bone transforms. Returns the number of capsules that can be hit */
+	int32 UpdateBlock(const FHitboxBlock& Block);
+
+	/** Removes a block and closes the gap it leaves in the packed arrays */
+	void RemoveBlock(int32 BlockIndex);
+
+	/** Grows or shrinks the packed arrays to hold the capsule count, keeping the padding unhittable */
+	void ResizeCapsules(int32 NewNumCapsules);
+};
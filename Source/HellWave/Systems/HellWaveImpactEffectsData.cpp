@@ -0,0 +1,9 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveImpactEffectsData.h"
+
+const FHellWaveImpactEffect& UHellWaveImpactEffectsData::GetEffect(EPhysicalSurface SurfaceType) const
+{
+	const FHellWaveImpactEffect* Effect = SurfaceEffects.Find(SurfaceType);
+	return Effect ? *Effect : DefaultEffect;
+}
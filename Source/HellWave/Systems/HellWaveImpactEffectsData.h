@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "HellWaveImpactEffectsData.generated.h"
+
+class UNiagaraSystem;
+class UMaterialInterface;
+class USoundBase;
+
+/**
+ *  Particles, decal and sound played for an impact on one surface type
+ */
+USTRUCT(BlueprintType)
+struct FHellWaveImpactEffect
+{
+	GENERATED_BODY()
+
+	/** Particle system spawned at the impact */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	TObjectPtr<UNiagaraSystem> Particles;
+
+	/** Decal material projected onto the surface. No decal if unset */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	TObjectPtr<UMaterialInterface> DecalMaterial;
+
+	/** Decal extent */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	FVector DecalSize = FVector(4.0f, 8.0f, 8.0f);
+
+	/** Sound played at the impact */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	TObjectPtr<USoundBase> Sound;
+};
+
+/**
+ *  Impact effects for each physical surface type
+ *  Read by the impact effects subsystem
+ */
+UCLASS(BlueprintType)
+class HELLWAVE_API UHellWaveImpactEffectsData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Effect used when a surface type has no entry */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	FHellWaveImpactEffect DefaultEffect;
+
+	/** Effects for specific surface types */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	TMap<TEnumAsByte<EPhysicalSurface>, FHellWaveImpactEffect> SurfaceEffects;
+
+	/** Surface type used for pawns hit without a physical material, such as hitbox hits */
+	UPROPERTY(EditAnywhere, Category="Impact")
+	TEnumAsByte<EPhysicalSurface> PawnSurfaceType = SurfaceType_Default;
+
+	/** Returns the effect for a surface type */
+	const FHellWaveImpactEffect& GetEffect(EPhysicalSurface SurfaceType) const;
+};
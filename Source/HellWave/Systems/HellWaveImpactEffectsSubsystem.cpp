@@ -0,0 +1,285 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveImpactEffectsSubsystem.h"
+#include "HellWaveImpactEffectsData.h"
+#include "HellWaveAudioEventSubsystem.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "Components/DecalComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Impact Effects Flush"), STAT_HellWaveImpactFlush, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impacts Requested"), STAT_HellWaveImpactsRequested, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impacts Played"), STAT_HellWaveImpactsPlayed, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impacts Dropped"), STAT_HellWaveImpactsDropped, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Particles Skipped"), STAT_HellWaveImpactParticlesSkipped, STATGROUP_HellWave);
+
+bool UHellWaveImpactEffectsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveImpactEffectsSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	EffectsData = ImpactEffects.LoadSynchronous();
+
+	if (!EffectsData)
+	{
+		// Every surface plays the fallback effect until a per-surface asset is authored
+		EffectsData = NewObject<UHellWaveImpactEffectsData>(this);
+		EffectsData->DefaultEffect.Particles = FallbackParticles.LoadSynchronous();
+		EffectsData->DefaultEffect.DecalMaterial = FallbackDecalMaterial.LoadSynchronous();
+		EffectsData->DefaultEffect.Sound = FallbackSound.LoadSynchronous();
+
+		const FHellWaveImpactEffect& Fallback = EffectsData->DefaultEffect;
+		if (!Fallback.Particles && !Fallback.DecalMaterial && !Fallback.Sound)
+		{
+			UE_LOG(LogHellWave, Warning, TEXT("No impact effects set for the impact effects subsystem. Set ImpactEffects or the fallback effect under [/Script/HellWave.HellWaveImpactEffectsSubsystem] in DefaultGame.ini. Weapon impacts will play no effects"));
+			EffectsData = nullptr;
+		}
+	}
+}
+
+void UHellWaveImpactEffectsSubsystem::Deinitialize()
+{
+	// Pooled particles are held with manual release, so hand them back to the world pool
+	for (UNiagaraComponent* Particles : ParticlePool)
+	{
+		if (IsValid(Particles))
+		{
+			Particles->ReleaseToPool();
+		}
+	}
+
+	ParticlePool.Empty();
+	DecalRing.Empty();
+	PendingImpacts.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHellWaveImpactEffectsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushImpacts();
+}
+
+TStatId UHellWaveImpactEffectsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHellWaveImpactEffectsSubsystem, STATGROUP_Tickables);
+}
+
+void UHellWaveImpactEffectsSubsystem::RequestImpact(const FHitResult& Hit)
+{
+	// Nothing to play, so skip the surface lookup and merging
+	if (!EffectsData)
+	{
+		return;
+	}
+
+	// Pawns without a traced physical material, such as hitbox hits, use the pawn surface
+	EPhysicalSurface SurfaceType = SurfaceType_Default;
+	const UPhysicalMaterial* PhysMaterial = Hit.PhysMaterial.Get();
+
+	if (!PhysMaterial && Cast<APawn>(Hit.GetActor()))
+	{
+		SurfaceType = EffectsData->PawnSurfaceType;
+	}
+	else
+	{
+		// Sweeps don't return a physical material, so fall back to the hit body's
+		if (!PhysMaterial && Hit.GetComponent())
+		{
+			if (const FBodyInstance* Body = Hit.GetComponent()->GetBodyInstance(Hit.BoneName))
+			{
+				PhysMaterial = Body->GetSimplePhysicalMaterial();
+			}
+		}
+
+		SurfaceType = UPhysicalMaterial::DetermineSurfaceType(PhysMaterial);
+	}
+
+	RequestImpact(Hit.ImpactPoint, Hit.ImpactNormal, SurfaceType);
+}
+
+void UHellWaveImpactEffectsSubsystem::RequestImpact(const FVector& Location, const FVector& Normal, EPhysicalSurface SurfaceType)
+{
+	if (!EffectsData)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_HellWaveImpactsRequested);
+
+	// Merge into a nearby impact on the same surface
+	const float MergeRadiusSq = FMath::Square(MergeRadius);
+
+	for (FImpactRequest& Request : PendingImpacts)
+	{
+		if (Request.SurfaceType == SurfaceType && FVector::DistSquared(Request.Location, Location) <= MergeRadiusSq)
+		{
+			// Keep the merged impact at the average location
+			++Request.Count;
+			Request.Location += (Location - Request.Location) / Request.Count;
+			return;
+		}
+	}
+
+	PendingImpacts.Add({ Location, Normal, SurfaceType, 1 });
+}
+
+void UHellWaveImpactEffectsSubsystem::FlushImpacts()
+{
+	if (PendingImpacts.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveImpactFlush);
+
+	if (EffectsData)
+	{
+		const int32 NumToPlay = FMath::Min(PendingImpacts.Num(), MaxImpactsPerFrame);
+		UHellWaveAudioEventSubsystem* AudioEvents = GetWorld()->GetSubsystem<UHellWaveAudioEventSubsystem>();
+
+		for (int32 ImpactIndex = 0; ImpactIndex < NumToPlay; ++ImpactIndex)
+		{
+			const FImpactRequest& Request = PendingImpacts[ImpactIndex];
+			const FHellWaveImpactEffect& Effect = EffectsData->GetEffect(Request.SurfaceType);
+
+			if (Effect.Particles)
+			{
+				SpawnParticles(Effect.Particles, Request.Location, Request.Normal.Rotation());
+			}
+
+			if (Effect.DecalMaterial)
+			{
+				// Decals project along their X axis. Vary the roll so repeated hits don't line up
+				FRotator DecalRotation = (-Request.Normal).Rotation();
+				DecalRotation.Roll = (NextDecal * 137) % 360;
+
+				SpawnDecal(Effect.DecalMaterial, Effect.DecalSize, Request.Location, DecalRotation);
+			}
+
+			// The audio layer collapses distant impacts and budgets voices along with the gunfire
+			if (Effect.Sound && AudioEvents)
+			{
+				AudioEvents->PostSoundEvent(Effect.Sound, nullptr, Request.Location, Request.Count);
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_HellWaveImpactsPlayed, NumToPlay);
+		INC_DWORD_STAT_BY(STAT_HellWaveImpactsDropped, PendingImpacts.Num() - NumToPlay);
+	}
+
+	// Keep the allocation for the next frame
+	PendingImpacts.Reset();
+}
+
+void UHellWaveImpactEffectsSubsystem::SpawnParticles(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation)
+{
+	if (MaxLiveParticles <= 0)
+	{
+		return;
+	}
+
+	// Grow the pool until it reaches the live budget
+	if (ParticlePool.Num() < MaxLiveParticles)
+	{
+		if (UNiagaraComponent* Particles = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, Location, Rotation, FVector::OneVector, false, true, ENCPoolMethod::ManualRelease))
+		{
+			ParticlePool.Add(Particles);
+		}
+
+		return;
+	}
+
+	// Reuse the next component whose effect has finished. Live effects are never cut off
+	int32 SlotIndex = INDEX_NONE;
+
+	for (int32 Checked = 0; Checked < ParticlePool.Num(); ++Checked)
+	{
+		const int32 CandidateIndex = (NextParticle + Checked) % ParticlePool.Num();
+
+		if (!IsValid(ParticlePool[CandidateIndex]) || !ParticlePool[CandidateIndex]->IsActive())
+		{
+			SlotIndex = CandidateIndex;
+			break;
+		}
+	}
+
+	if (SlotIndex == INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_HellWaveImpactParticlesSkipped);
+		return;
+	}
+
+	NextParticle = (SlotIndex + 1) % ParticlePool.Num();
+	TObjectPtr<UNiagaraComponent>& Slot = ParticlePool[SlotIndex];
+
+	if (!IsValid(Slot))
+	{
+		Slot = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, Location, Rotation, FVector::OneVector, false, true, ENCPoolMethod::ManualRelease);
+		return;
+	}
+
+	if (Slot->GetAsset() != System)
+	{
+		Slot->SetAsset(System);
+	}
+
+	Slot->SetWorldLocationAndRotation(Location, Rotation);
+	Slot->Activate(true);
+}
+
+void UHellWaveImpactEffectsSubsystem::SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation)
+{
+	if (MaxDecals <= 0)
+	{
+		return;
+	}
+
+	// Grow the ring until it reaches the decal budget
+	if (DecalRing.Num() < MaxDecals)
+	{
+		if (UDecalComponent* Decal = UGameplayStatics::SpawnDecalAtLocation(GetWorld(), Material, Size, Location, Rotation, 0.0f))
+		{
+			DecalRing.Add(Decal);
+		}
+
+		++NextDecal;
+		return;
+	}
+
+	// Move the oldest decal
+	const int32 RingIndex = NextDecal % DecalRing.Num();
+	++NextDecal;
+
+	UDecalComponent* Decal = DecalRing[RingIndex];
+
+	if (!IsValid(Decal))
+	{
+		DecalRing[RingIndex] = UGameplayStatics::SpawnDecalAtLocation(GetWorld(), Material, Size, Location, Rotation, 0.0f);
+		return;
+	}
+
+	if (Decal->GetDecalMaterial() != Material)
+	{
+		Decal->SetDecalMaterial(Material);
+	}
+
+	if (Decal->DecalSize != Size)
+	{
+		Decal->DecalSize = Size;
+		Decal->MarkRenderStateDirty();
+	}
+
+	Decal->SetWorldLocationAndRotation(Location, Rotation);
+}
@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "HellWaveImpactEffectsSubsystem.generated.h"
+
+class UHellWaveImpactEffectsData;
+class UNiagaraSystem;
+class UNiagaraComponent;
+class UDecalComponent;
+class UMaterialInterface;
+class USoundBase;
+
+/**
+ *  Plays impact particles, decals and sounds for weapon hits
+ *  Impacts of the same surface type that land close together in a frame are merged into one
+ *  Particles come from a pool of reused Niagara components, and decals from a ring buffer
+ *  Both are capped, along with the number of impacts played each frame
+ *  Sounds are posted to the audio event layer, which collapses and budgets them with the gunfire
+ *  Without an impact effects asset in the config, every surface plays the fallback effect set in the config
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UHellWaveImpactEffectsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Impact effects for each surface type. Loaded when the world begins play. The fallback effect is used if unset */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UHellWaveImpactEffectsData> ImpactEffects;
+
+	/** Particles played on every surface when no impact effects asset is set */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UNiagaraSystem> FallbackParticles;
+
+	/** Decal projected on every surface when no impact effects asset is set */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UMaterialInterface> FallbackDecalMaterial;
+
+	/** Sound played on every surface when no impact effects asset is set */
+	UPROPERTY(Config)
+	TSoftObjectPtr<USoundBase> FallbackSound;
+
+	/** Impacts of the same surface type within this distance in a frame are merged */
+	UPROPERTY(Config)
+	float MergeRadius = 30.0f;
+
+	/** Maximum number of impacts played per frame. Extra impacts are dropped */
+	UPROPERTY(Config)
+	int32 MaxImpactsPerFrame = 16;
+
+	/** Maximum number of live impact particle systems. Impacts past this play no particles until one finishes */
+	UPROPERTY(Config)
+	int32 MaxLiveParticles = 48;
+
+	/** Maximum number of impact decals. The oldest is recycled past this */
+	UPROPERTY(Config)
+	int32 MaxDecals = 64;
+
+	/** Loaded impact effects, or a transient asset holding the fallback effect */
+	UPROPERTY(Transient)
+	TObjectPtr<UHellWaveImpactEffectsData> EffectsData;
+
+	/** Pooled particle components, reused once their effect has finished */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNiagaraComponent>> ParticlePool;
+
+	/** Pooled decal components, recycled oldest first once the ring is full */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UDecalComponent>> DecalRing;
+
+	/** Next particle component to check for reuse */
+	int32 NextParticle = 0;
+
+	/** Next decal component to recycle */
+	int32 NextDecal = 0;
+
+	/** An impact waiting for the end of frame flush */
+	struct FImpactRequest
+	{
+		FVector Location;
+		FVector Normal;
+		EPhysicalSurface SurfaceType;
+
+		/** Number of impacts merged into this one */
+		int32 Count;
+	};
+
+	/** Impacts requested this frame */
+	TArray<FImpactRequest> PendingImpacts;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Loads the impact effects */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the pooled components */
+	virtual void Deinitialize() override;
+
+	/** Plays the impacts requested this frame */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Requests an impact for a hit. The surface type comes from the hit's physical material */
+	void RequestImpact(const FHitResult& Hit);
+
+	/** Requests an impact on a surface type */
+	void RequestImpact(const FVector& Location, const FVector& Normal, EPhysicalSurface SurfaceType);
+
+protected:
+
+	/** Plays the pending impacts within the frame budgets */
+	void FlushImpacts();
+
+	/** Plays a particle system on a pooled component. Skipped if every pooled component is still playing */
+	void SpawnParticles(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation);
+
+	/** Places a decal from the ring buffer */
+	void SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation);
+};
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveImpulseSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Impulse Flush"), STAT_HellWaveImpulseFlush, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impulses Queued"), STAT_HellWaveImpulsesQueued, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impulses Applied"), STAT_HellWaveImpulsesApplied, STATGROUP_HellWave);
+
+bool UHellWaveImpulseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveImpulseSubsystem::AddImpulseAtLocation(UPrimitiveComponent* Component, const FVector& Impulse, const FVector& Location, FName BoneName)
+{
+	// A killing shot's target only starts simulating when its damage resolves, so only rule out bodies that can never move
+	if (!Component || Component->Mobility != EComponentMobility::Movable)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_HellWaveImpulsesQueued);
+
+	const float Magnitude = Impulse.Size();
+
+	FBucketKey Key;
+	Key.Body.Component = Component;
+	Key.Body.BoneName = BoneName;
+	Key.Cell = FIntVector(
+		FMath::FloorToInt32(Location.X / BucketSize),
+		FMath::FloorToInt32(Location.Y / BucketSize),
+		FMath::FloorToInt32(Location.Z / BucketSize));
+
+	FBucket& Bucket = Buckets.FindOrAdd(Key);
+	Bucket.Impulse += Impulse;
+	Bucket.WeightedLocation += Location * Magnitude;
+	Bucket.Weight += Magnitude;
+
+	BodyMagnitudes.FindOrAdd(Key.Body) += Magnitude;
+}
+
+void UHellWaveImpulseSubsystem::Flush()
+{
+	if (Buckets.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveImpulseFlush);
+
+	for (const TPair<FBucketKey, FBucket>& Pair : Buckets)
+	{
+		UPrimitiveComponent* Component = Pair.Key.Body.Component.Get();
+
+		// The body may have been destroyed or stopped simulating since the impulse was queued
+		if (!Component || !Component->IsSimulatingPhysics(Pair.Key.Body.BoneName))
+		{
+			continue;
+		}
+
+		const FBucket& Bucket = Pair.Value;
+		if (Bucket.Weight <= UE_KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		FVector Impulse = Bucket.Impulse;
+
+		// Scale every bucket on an over the cap body down by the same ratio
+		const float BodyMagnitude = BodyMagnitudes.FindChecked(Pair.Key.Body);
+		if (MaxImpulsePerBody > 0.0f && BodyMagnitude > MaxImpulsePerBody)
+		{
+			Impulse *= MaxImpulsePerBody / BodyMagnitude;
+		}
+
+		Component->AddImpulseAtLocation(Impulse, Bucket.WeightedLocation / Bucket.Weight, Pair.Key.Body.BoneName);
+
+		INC_DWORD_STAT(STAT_HellWaveImpulsesApplied);
+	}
+
+	// Keep the allocations for the next frame
+	Buckets.Reset();
+	BodyMagnitudes.Reset();
+}
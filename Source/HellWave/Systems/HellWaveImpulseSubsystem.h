@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveImpulseSubsystem.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ *  Accumulates physics impulses for a frame and flushes them to physics in one batch
+ *  Impulses on the same body that land close together are summed into a single impulse
+ *  The total impulse each body receives per frame is capped
+ *  Flushed by UHellWaveEndOfFrameSubsystem after damage resolves, so bodies that start simulating on a killing shot
+ *  still receive it. Queued impulses are simulated on the next physics step
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UHellWaveImpulseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Impulses landing on the same body within this distance are summed */
+	UPROPERTY(Config)
+	float BucketSize = 50.0f;
+
+	/** Maximum total impulse a single body can receive per frame. Zero disables the cap */
+	UPROPERTY(Config)
+	float MaxImpulsePerBody = 100000.0f;
+
+	/** A body is a component, plus the bone for skeletal meshes */
+	struct FBodyKey
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		FName BoneName;
+
+		bool operator==(const FBodyKey& Other) const { return Component == Other.Component && BoneName == Other.BoneName; }
+		friend uint32 GetTypeHash(const FBodyKey& Key) { return HashCombineFast(GetTypeHash(Key.Component), GetTypeHash(Key.BoneName)); }
+	};
+
+	/** A body and a quantized location on it */
+	struct FBucketKey
+	{
+		FBodyKey Body;
+		FIntVector Cell;
+
+		bool operator==(const FBucketKey& Other) const { return Body == Other.Body && Cell == Other.Cell; }
+		friend uint32 GetTypeHash(const FBucketKey& Key) { return HashCombineFast(GetTypeHash(Key.Body), GetTypeHash(Key.Cell)); }
+	};
+
+	/** Summed impulse for a bucket */
+	struct FBucket
+	{
+		FVector Impulse = FVector::ZeroVector;
+
+		/** Locations weighted by impulse magnitude, averaged on flush */
+		FVector WeightedLocation = FVector::ZeroVector;
+		float Weight = 0.0f;
+	};
+
+	/** Impulses queued this frame */
+	TMap<FBucketKey, FBucket> Buckets;
+
+	/** Total impulse magnitude queued on each body this frame */
+	TMap<FBodyKey, float> BodyMagnitudes;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Queues an impulse at a world location. Bodies that aren't simulating physics yet are checked again on flush */
+	void AddImpulseAtLocation(UPrimitiveComponent* Component, const FVector& Impulse, const FVector& Location, FName BoneName = NAME_None);
+
+	/** Applies every queued impulse to physics */
+	void Flush();
+};
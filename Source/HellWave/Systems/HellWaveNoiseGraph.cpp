@@ -0,0 +1,209 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveNoiseGraph.h"
+#include "HellWaveNoiseGraphData.h"
+#include "HellWaveNoiseSubsystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Logging/MessageLog.h"
+#include "Misc/UObjectToken.h"
+#include "HellWave.h"
+
+#define LOCTEXT_NAMESPACE "HellWaveNoiseGraph"
+
+AHellWaveNoiseGraph::AHellWaveNoiseGraph()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void AHellWaveNoiseGraph::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// hand the baked graph to the world
+	if (GraphData)
+	{
+		if (UHellWaveNoiseSubsystem* Noises = GetWorld()->GetSubsystem<UHellWaveNoiseSubsystem>())
+		{
+			Noises->SetNoiseGraph(GraphData);
+		}
+	}
+}
+
+void AHellWaveNoiseGraph::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	if (UHellWaveNoiseSubsystem* Noises = GetWorld()->GetSubsystem<UHellWaveNoiseSubsystem>())
+	{
+		Noises->ClearNoiseGraph(GraphData);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+
+void AHellWaveNoiseGraph::BakeNoiseGraph()
+{
+	if (!GraphData)
+	{
+		UE_LOG(LogHellWave, Error, TEXT("%s: assign a noise graph data asset before baking."), *GetName());
+		return;
+	}
+
+	GraphData->Rooms.Reset();
+	GraphData->Portals.Reset();
+	GraphData->PortalAttenuation = PortalAttenuation;
+
+	for (AActor* RoomActor : GatherTaggedActors(RoomTag))
+	{
+		FHellWaveNoiseRoom& Room = GraphData->Rooms.AddDefaulted_GetRef();
+		Room.RoomName = RoomActor->GetFName();
+		Room.Bounds = RoomActor->GetComponentsBoundingBox(true);
+	}
+
+	// connect each portal to the two rooms it sits between
+	const float ToleranceSquared = FMath::Square(PortalTolerance);
+
+	for (AActor* PortalActor : GatherTaggedActors(PortalTag))
+	{
+		if (GraphData->Portals.Num() >= UHellWaveNoiseGraphData::MaxPortals)
+		{
+			UE_LOG(LogHellWave, Warning, TEXT("%s: more than %d portals found, the rest will be skipped."), *GetName(), UHellWaveNoiseGraphData::MaxPortals);
+			break;
+		}
+
+		const FVector Location = PortalActor->GetComponentsBoundingBox(true).GetCenter();
+
+		TArray<int32, TInlineAllocator<2>> PortalRooms;
+
+		for (int32 RoomIndex = 0; RoomIndex < GraphData->Rooms.Num(); ++RoomIndex)
+		{
+			if (GraphData->Rooms[RoomIndex].Bounds.ComputeSquaredDistanceToPoint(Location) <= ToleranceSquared)
+			{
+				PortalRooms.Add(RoomIndex);
+			}
+		}
+
+		if (PortalRooms.Num() != 2)
+		{
+			UE_LOG(LogHellWave, Warning, TEXT("%s: portal %s touches %d rooms instead of 2 and will be skipped."), *GetName(), *PortalActor->GetName(), PortalRooms.Num());
+			continue;
+		}
+
+		const int32 PortalIndex = GraphData->Portals.Num();
+
+		FHellWaveNoisePortal& Portal = GraphData->Portals.AddDefaulted_GetRef();
+		Portal.Location = Location;
+		Portal.RoomA = PortalRooms[0];
+		Portal.RoomB = PortalRooms[1];
+
+		GraphData->Rooms[Portal.RoomA].Portals.Add(PortalIndex);
+		GraphData->Rooms[Portal.RoomB].Portals.Add(PortalIndex);
+	}
+
+	// portals sharing a room are connected by a straight line across it
+	const int32 NumPortals = GraphData->Portals.Num();
+
+	GraphData->PortalDistances.Init(-1.0f, NumPortals * NumPortals);
+	GraphData->PortalCounts.Init(0, NumPortals * NumPortals);
+
+	TArray<float>& Distances = GraphData->PortalDistances;
+	TArray<uint8>& Counts = GraphData->PortalCounts;
+
+	for (int32 PortalIndex = 0; PortalIndex < NumPortals; ++PortalIndex)
+	{
+		Distances[PortalIndex * NumPortals + PortalIndex] = 0.0f;
+		Counts[PortalIndex * NumPortals + PortalIndex] = 1;
+	}
+
+	for (const FHellWaveNoiseRoom& Room : GraphData->Rooms)
+	{
+		for (const int32 From : Room.Portals)
+		{
+			for (const int32 To : Room.Portals)
+			{
+				if (From != To)
+				{
+					Distances[From * NumPortals + To] = FVector::Dist(GraphData->Portals[From].Location, GraphData->Portals[To].Location);
+					Counts[From * NumPortals + To] = 2;
+				}
+			}
+		}
+	}
+
+	// all pairs shortest paths, so runtime lookups are a table read
+	for (int32 Via = 0; Via < NumPortals; ++Via)
+	{
+		for (int32 From = 0; From < NumPortals; ++From)
+		{
+			const float FromVia = Distances[From * NumPortals + Via];
+			if (FromVia < 0.0f)
+			{
+				continue;
+			}
+
+			for (int32 To = 0; To < NumPortals; ++To)
+			{
+				const float ViaTo = Distances[Via * NumPortals + To];
+				if (ViaTo < 0.0f)
+				{
+					continue;
+				}
+
+				float& FromTo = Distances[From * NumPortals + To];
+				if (FromTo < 0.0f || FromVia + ViaTo < FromTo)
+				{
+					FromTo = FromVia + ViaTo;
+
+					// the via portal is counted on both halves
+					Counts[From * NumPortals + To] = Counts[From * NumPortals + Via] + Counts[Via * NumPortals + To] - 1;
+				}
+			}
+		}
+	}
+
+	GraphData->MarkPackageDirty();
+
+	UE_LOG(LogHellWave, Log, TEXT("%s: baked %d rooms and %d portals into %s."), *GetName(), GraphData->Rooms.Num(), NumPortals, *GraphData->GetName());
+}
+
+void AHellWaveNoiseGraph::CheckForErrors()
+{
+	Super::CheckForErrors();
+
+	if (!GraphData)
+	{
+		FMessageLog("MapCheck").Warning()
+			->AddToken(FUObjectToken::Create(this))
+			->AddToken(FTextToken::Create(LOCTEXT("MissingGraphData", "Noise graph has no graph data asset. AI will hear noises through walls")));
+	}
+	else if (GraphData->Rooms.IsEmpty())
+	{
+		FMessageLog("MapCheck").Warning()
+			->AddToken(FUObjectToken::Create(this))
+			->AddToken(FTextToken::Create(LOCTEXT("UnbakedGraph", "Noise graph has no baked rooms. Tag the level's rooms and portals and run Bake Noise Graph")));
+	}
+}
+
+TArray<AActor*> AHellWaveNoiseGraph::GatherTaggedActors(FName Tag) const
+{
+	TArray<AActor*> Found;
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (It->Tags.Contains(Tag))
+		{
+			Found.Add(*It);
+		}
+	}
+
+	Found.Sort([](const AActor& A, const AActor& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+
+	return Found;
+}
+
+#endif // WITH_EDITOR
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HellWaveNoiseGraph.generated.h"
+
+class UHellWaveNoiseGraphData;
+
+/**
+ *  Bakes the room and portal graph AI hearing noise propagates through
+ *  Place one per level and assign a graph data asset. Rooms and portals are tagged actors in the level
+ *  At runtime it hands the baked graph to UHellWaveNoiseSubsystem
+ */
+UCLASS()
+class HELLWAVE_API AHellWaveNoiseGraph : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Asset that receives the baked graph */
+	UPROPERTY(EditAnywhere, Category="Bake")
+	TObjectPtr<UHellWaveNoiseGraphData> GraphData;
+
+	/** Tag used to find room actors. Room extents come from the actor bounds */
+	UPROPERTY(EditAnywhere, Category="Bake")
+	FName RoomTag = FName("NoiseRoom");
+
+	/** Tag used to find portal actors. Each portal must sit on the boundary between exactly two rooms */
+	UPROPERTY(EditAnywhere, Category="Bake")
+	FName PortalTag = FName("NoisePortal");
+
+	/** Distance a portal can sit outside a room's bounds and still connect to it */
+	UPROPERTY(EditAnywhere, Category="Bake", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float PortalTolerance = 50.0f;
+
+	/** Loudness multiplier applied each time a noise passes through a portal */
+	UPROPERTY(EditAnywhere, Category="Bake", meta = (ClampMin = 0, ClampMax = 1))
+	float PortalAttenuation = 0.6f;
+
+public:
+
+	/** Constructor */
+	AHellWaveNoiseGraph();
+
+protected:
+
+	/** Registers the baked graph with the world */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the baked graph */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+#if WITH_EDITOR
+	/** Bakes rooms, portals and the portal-to-portal distance tables into the data asset */
+	UFUNCTION(CallInEditor, Category="Bake")
+	void BakeNoiseGraph();
+
+	/** Warns if the graph has no data asset or hasn't been baked */
+	virtual void CheckForErrors() override;
+#endif // WITH_EDITOR
+
+protected:
+
+#if WITH_EDITOR
+	/** Returns every actor in the level carrying the tag, sorted by name for stable bake order */
+	TArray<AActor*> GatherTaggedActors(FName Tag) const;
+#endif // WITH_EDITOR
+};
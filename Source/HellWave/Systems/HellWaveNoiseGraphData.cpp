@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveNoiseGraphData.h"
+
+int32 UHellWaveNoiseGraphData::FindRoom(const FVector& Location) const
+{
+	for (int32 RoomIndex = 0; RoomIndex < Rooms.Num(); ++RoomIndex)
+	{
+		if (Rooms[RoomIndex].Bounds.IsInsideOrOn(Location))
+		{
+			return RoomIndex;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+bool UHellWaveNoiseGraphData::FindPath(const FVector& NoiseLocation, int32 NoiseRoom, int32 ListenerRoom, FHellWaveNoisePath& OutPath) const
+{
+	OutPath = FHellWaveNoisePath();
+
+	if (!Rooms.IsValidIndex(NoiseRoom) || !Rooms.IsValidIndex(ListenerRoom) || NoiseRoom == ListenerRoom)
+	{
+		return false;
+	}
+
+	// try every exit from the noise's room against every entry into the listener's room
+	for (const int32 ExitPortal : Rooms[NoiseRoom].Portals)
+	{
+		const float ExitDistance = FVector::Dist(NoiseLocation, Portals[ExitPortal].Location);
+
+		for (const int32 EntryPortal : Rooms[ListenerRoom].Portals)
+		{
+			const float PortalDistance = GetPortalDistance(ExitPortal, EntryPortal);
+			if (PortalDistance < 0.0f)
+			{
+				continue;
+			}
+
+			const float Distance = ExitDistance + PortalDistance;
+			if (OutPath.EntryPortal == INDEX_NONE || Distance < OutPath.Distance)
+			{
+				OutPath.EntryPortal = EntryPortal;
+				OutPath.Distance = Distance;
+				OutPath.NumPortals = PortalCounts[ExitPortal * Portals.Num() + EntryPortal];
+			}
+		}
+	}
+
+	return OutPath.EntryPortal != INDEX_NONE;
+}
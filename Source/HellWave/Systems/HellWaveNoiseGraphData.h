@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HellWaveNoiseGraphData.generated.h"
+
+/**
+ *  A room that noise propagates through, connected to other rooms by portals
+ */
+USTRUCT()
+struct FHellWaveNoiseRoom
+{
+	GENERATED_BODY()
+
+	/** Name of the room actor this was baked from */
+	UPROPERTY(VisibleAnywhere, Category="Room")
+	FName RoomName;
+
+	/** World space bounds of the room */
+	UPROPERTY(VisibleAnywhere, Category="Room")
+	FBox Bounds = FBox(ForceInit);
+
+	/** Indices of the portals leading out of this room */
+	UPROPERTY(VisibleAnywhere, Category="Room")
+	TArray<int32> Portals;
+};
+
+/**
+ *  An opening between two rooms, such as a door or a window
+ */
+USTRUCT()
+struct FHellWaveNoisePortal
+{
+	GENERATED_BODY()
+
+	/** World space center of the opening */
+	UPROPERTY(VisibleAnywhere, Category="Portal")
+	FVector Location = FVector::ZeroVector;
+
+	/** Rooms on either side of the portal */
+	UPROPERTY(VisibleAnywhere, Category="Portal")
+	int32 RoomA = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, Category="Portal")
+	int32 RoomB = INDEX_NONE;
+};
+
+/**
+ *  Route a noise takes from its room into a listener's room
+ */
+struct FHellWaveNoisePath
+{
+	/** Portal the noise enters the listener's room through */
+	int32 EntryPortal = INDEX_NONE;
+
+	/** Travel distance from the noise to the entry portal */
+	float Distance = 0.0f;
+
+	/** Number of portals the noise passes through */
+	int32 NumPortals = 0;
+};
+
+/**
+ *  Editor-baked room and portal graph used to propagate AI hearing noise around walls
+ *  Produced by AHellWaveNoiseGraph and consumed at runtime through UHellWaveNoiseSubsystem
+ */
+UCLASS(BlueprintType)
+class HELLWAVE_API UHellWaveNoiseGraphData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Max number of portals. The portal-to-portal tables grow with the square of this */
+	static constexpr int32 MaxPortals = 255;
+
+	/** Rooms, in bake order */
+	UPROPERTY(VisibleAnywhere, Category="Rooms")
+	TArray<FHellWaveNoiseRoom> Rooms;
+
+	/** Portals, in bake order */
+	UPROPERTY(VisibleAnywhere, Category="Portals")
+	TArray<FHellWaveNoisePortal> Portals;
+
+	/** Loudness multiplier applied each time a noise passes through a portal */
+	UPROPERTY(VisibleAnywhere, Category="Portals", meta = (ClampMin = 0, ClampMax = 1))
+	float PortalAttenuation = 0.6f;
+
+	/** Shortest travel distance between two portals, indexed [From * NumPortals + To]. Negative if unreachable */
+	UPROPERTY()
+	TArray<float> PortalDistances;
+
+	/** Number of portals on the shortest path between two portals, both ends included, indexed [From * NumPortals + To] */
+	UPROPERTY()
+	TArray<uint8> PortalCounts;
+
+public:
+
+	/** Returns true if a graph has been baked */
+	bool HasGraph() const { return !Rooms.IsEmpty(); }
+
+	/** Returns the index of the room containing the location, or INDEX_NONE if it's outside every room */
+	int32 FindRoom(const FVector& Location) const;
+
+	/** Returns the shortest travel distance between two portals. Negative if unreachable */
+	float GetPortalDistance(int32 FromPortal, int32 ToPortal) const { return PortalDistances[FromPortal * Portals.Num() + ToPortal]; }
+
+	/** Finds the shortest route for a noise from its room into another room. Returns false if the rooms aren't connected */
+	bool FindPath(const FVector& NoiseLocation, int32 NoiseRoom, int32 ListenerRoom, FHellWaveNoisePath& OutPath) const;
+
+	/** Returns the loudness multiplier for a noise passing through a number of portals */
+	float GetAttenuation(int32 NumPortals) const { return FMath::Pow(PortalAttenuation, static_cast<float>(NumPortals)); }
+};
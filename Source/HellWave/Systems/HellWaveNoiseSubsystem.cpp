@@ -0,0 +1,314 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveNoiseSubsystem.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Perception/AISense_Hearing.h"
+#include "Perception/AISenseConfig_Hearing.h"
+#include "Perception/AIPerceptionComponent.h"
+#include "HellWaveNoiseGraphData.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Noise Flush"), STAT_HellWaveNoiseFlush, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noises Reported"), STAT_HellWaveNoisesReported, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noises Delivered"), STAT_HellWaveNoisesDelivered, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noises Culled"), STAT_HellWaveNoisesCulled, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noise Graph Stimuli"), STAT_HellWaveNoiseStimuli, STATGROUP_HellWave);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Noise Listener Cells"), STAT_HellWaveNoiseListenerCells, STATGROUP_HellWave);
+
+namespace
+{
+	FIntVector ToCell(const FVector& Location, float CellSize)
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+	}
+}
+
+bool UHellWaveNoiseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveNoiseSubsystem::ReportNoise(float Loudness, AActor* Instigator, const FVector& Location, float MaxRange, FName Tag)
+{
+	INC_DWORD_STAT(STAT_HellWaveNoisesReported);
+
+	const FNoiseKey Key { Instigator, Tag, ToCell(Location, FMath::Max(MergeCellSize, 1.0f)) };
+
+	int32& NoiseIndex = PendingNoiseIndices.FindOrAdd(Key, INDEX_NONE);
+	if (NoiseIndex == INDEX_NONE)
+	{
+		NoiseIndex = PendingNoises.AddDefaulted();
+		PendingNoises[NoiseIndex].Instigator = Instigator;
+		PendingNoises[NoiseIndex].Tag = Tag;
+	}
+
+	FNoiseEvent& Noise = PendingNoises[NoiseIndex];
+	Noise.LocationSum += Location;
+	++Noise.Count;
+
+	Noise.Loudness = FMath::Max(Noise.Loudness, Loudness);
+
+	// A noise without a max range is unbounded, so it wins over any bounded one
+	if (Noise.Count == 1)
+	{
+		Noise.MaxRange = MaxRange;
+	}
+	else if (Noise.MaxRange > 0.0f)
+	{
+		Noise.MaxRange = MaxRange > 0.0f ? FMath::Max(Noise.MaxRange, MaxRange) : 0.0f;
+	}
+}
+
+void UHellWaveNoiseSubsystem::SetNoiseGraph(UHellWaveNoiseGraphData* InNoiseGraph)
+{
+	NoiseGraph = InNoiseGraph;
+}
+
+void UHellWaveNoiseSubsystem::ClearNoiseGraph(UHellWaveNoiseGraphData* InNoiseGraph)
+{
+	if (NoiseGraph == InNoiseGraph)
+	{
+		NoiseGraph = nullptr;
+	}
+}
+
+void UHellWaveNoiseSubsystem::FlushNoises()
+{
+	if (PendingNoises.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveNoiseFlush);
+
+	GatherListeners();
+
+	int32 NoisesDelivered = 0;
+
+	for (const FNoiseEvent& Noise : PendingNoises)
+	{
+		const FVector Location = Noise.LocationSum / Noise.Count;
+
+		// Noises inside the graph travel through portals instead of straight through walls.
+		// Noises without an instigator can't be registered as stimuli, so they go to the hearing sense below
+		if (NoiseGraph)
+		{
+			const int32 NoiseRoom = NoiseGraph->FindRoom(Location);
+			if (NoiseRoom != INDEX_NONE && PropagateNoise(Noise, Location, NoiseRoom))
+			{
+				++NoisesDelivered;
+				continue;
+			}
+		}
+
+		float Range = HearingRange * Noise.Loudness;
+		if (Noise.MaxRange > 0.0f)
+		{
+			Range = FMath::Min(Range, Noise.MaxRange);
+		}
+
+		if (IsListenerCellInRange(Location, Range))
+		{
+			UAISense_Hearing::ReportNoiseEvent(GetWorld(), Location, Noise.Loudness, Noise.Instigator.Get(), Noise.MaxRange, Noise.Tag);
+			++NoisesDelivered;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_HellWaveNoisesDelivered, NoisesDelivered);
+	INC_DWORD_STAT_BY(STAT_HellWaveNoisesCulled, PendingNoises.Num() - NoisesDelivered);
+
+	// Keep the allocations for the next frame
+	PendingNoises.Reset();
+	PendingNoiseIndices.Reset();
+}
+
+void UHellWaveNoiseSubsystem::GatherListeners()
+{
+	ListenerCells.Reset();
+	RoomListeners.Reset();
+
+	UAIPerceptionSystem* PerceptionSystem = UAIPerceptionSystem::GetCurrent(GetWorld());
+	if (!PerceptionSystem)
+	{
+		return;
+	}
+
+	const FAISenseID HearingID = UAISense::GetSenseID<UAISense_Hearing>();
+	const float CellSize = FMath::Max(ListenerCellSize, 1.0f);
+
+	for (const TPair<FPerceptionListenerID, FPerceptionListener>& Pair : PerceptionSystem->GetListenersMap())
+	{
+		const FPerceptionListener& Listener = Pair.Value;
+		if (!Listener.HasSense(HearingID))
+		{
+			continue;
+		}
+
+		ListenerCells.Add(ToCell(Listener.CachedLocation, CellSize));
+
+		UAIPerceptionComponent* Perception = Listener.Listener.Get();
+		if (!NoiseGraph || !Perception)
+		{
+			continue;
+		}
+
+		// Graph propagation skips the hearing sense, so it applies the listener's hearing config itself
+		const UAISenseConfig_Hearing* HearingConfig = Cast<UAISenseConfig_Hearing>(Perception->GetSenseConfig(HearingID));
+
+		FRoomListener& RoomListener = RoomListeners.AddDefaulted_GetRef();
+		RoomListener.Perception = Perception;
+		RoomListener.Body = Listener.GetBodyActor();
+		RoomListener.Location = Listener.CachedLocation;
+		RoomListener.TeamId = Listener.GetTeamIdentifier();
+		RoomListener.HearingRange = HearingConfig ? HearingConfig->HearingRange : HearingRange;
+		RoomListener.AffiliationFlags = HearingConfig ? HearingConfig->DetectionByAffiliation.GetAsFlags() : FAISenseAffiliationFilter::DetectAllFlags();
+		RoomListener.Room = NoiseGraph->FindRoom(Listener.CachedLocation);
+	}
+
+	// Listeners in the same room share one path lookup
+	RoomListeners.Sort([](const FRoomListener& A, const FRoomListener& B) { return A.Room < B.Room; });
+
+	SET_DWORD_STAT(STAT_HellWaveNoiseListenerCells, ListenerCells.Num());
+}
+
+bool UHellWaveNoiseSubsystem::PropagateNoise(const FNoiseEvent& Noise, const FVector& Location, int32 NoiseRoom)
+{
+	// Stimuli need a source actor
+	AActor* Instigator = Noise.Instigator.Get();
+	if (!Instigator)
+	{
+		return false;
+	}
+
+	const FGenericTeamId InstigatorTeam = FGenericTeamId::GetTeamIdentifier(Instigator);
+	const UAISense_Hearing& HearingSense = *GetDefault<UAISense_Hearing>();
+
+	FHellWaveNoisePath Path;
+	int32 PathRoom = INDEX_NONE;
+	bool bPathFound = false;
+
+	for (const FRoomListener& Listener : RoomListeners)
+	{
+		if (Listener.Body == Instigator || !FAISenseAffiliationFilter::ShouldSenseTeam(Listener.TeamId, InstigatorTeam, Listener.AffiliationFlags))
+		{
+			continue;
+		}
+
+		FVector PerceivedLocation = Location;
+		float Loudness = Noise.Loudness;
+		float Distance = 0.0f;
+
+		if (Listener.Room == NoiseRoom)
+		{
+			// Same room hears the noise directly
+			Distance = FVector::Dist(Location, Listener.Location);
+		}
+		else if (Listener.Room == INDEX_NONE)
+		{
+			// Outside the graph hears it through the nearest opening of the noise's room, not through its walls
+			int32 ExitPortal = INDEX_NONE;
+
+			for (const int32 PortalIndex : NoiseGraph->Rooms[NoiseRoom].Portals)
+			{
+				const FVector& PortalLocation = NoiseGraph->Portals[PortalIndex].Location;
+				const float PortalDistance = FVector::Dist(Location, PortalLocation) + FVector::Dist(PortalLocation, Listener.Location);
+
+				if (ExitPortal == INDEX_NONE || PortalDistance < Distance)
+				{
+					ExitPortal = PortalIndex;
+					Distance = PortalDistance;
+				}
+			}
+
+			if (ExitPortal == INDEX_NONE)
+			{
+				continue;
+			}
+
+			PerceivedLocation = NoiseGraph->Portals[ExitPortal].Location;
+			Loudness *= NoiseGraph->GetAttenuation(1);
+		}
+		else
+		{
+			if (Listener.Room != PathRoom)
+			{
+				PathRoom = Listener.Room;
+				bPathFound = NoiseGraph->FindPath(Location, NoiseRoom, PathRoom, Path);
+			}
+
+			if (!bPathFound)
+			{
+				continue;
+			}
+
+			// The noise is heard at the portal it came through, quieter for every portal it passed
+			PerceivedLocation = NoiseGraph->Portals[Path.EntryPortal].Location;
+			Distance = Path.Distance + FVector::Dist(PerceivedLocation, Listener.Location);
+			Loudness *= NoiseGraph->GetAttenuation(Path.NumPortals);
+		}
+
+		if (Distance > Listener.HearingRange * Loudness || (Noise.MaxRange > 0.0f && Distance > Noise.MaxRange))
+		{
+			continue;
+		}
+
+		if (UAIPerceptionComponent* Perception = Listener.Perception.Get())
+		{
+			Perception->RegisterStimulus(Instigator, FAIStimulus(HearingSense, Loudness, PerceivedLocation, Listener.Location, FAIStimulus::SensingSucceeded, Noise.Tag));
+			INC_DWORD_STAT(STAT_HellWaveNoiseStimuli);
+		}
+	}
+
+	return true;
+}
+
+bool UHellWaveNoiseSubsystem::IsListenerCellInRange(const FVector& Location, float Range) const
+{
+	const float CellSize = FMath::Max(ListenerCellSize, 1.0f);
+	const float RangeSq = FMath::Square(Range);
+
+	// Conservative test against the cell bounds. Perception does the exact check per listener
+	auto IsCellInRange = [&Location, CellSize, RangeSq](const FIntVector& Cell)
+	{
+		const FVector CellMin = FVector(Cell) * CellSize;
+		const FBox CellBox(CellMin, CellMin + FVector(CellSize));
+		return CellBox.ComputeSquaredDistanceToPoint(Location) <= RangeSq;
+	};
+
+	const FIntVector MinCell = ToCell(Location - FVector(Range), CellSize);
+	const FIntVector MaxCell = ToCell(Location + FVector(Range), CellSize);
+	const FIntVector CellSpan = MaxCell - MinCell + FIntVector(1);
+	const int64 NumCellsInRange = static_cast<int64>(CellSpan.X) * CellSpan.Y * CellSpan.Z;
+
+	// Walk whichever is smaller, the occupied cells or the cells the range covers
+	if (NumCellsInRange > ListenerCells.Num())
+	{
+		for (const FIntVector& Cell : ListenerCells)
+		{
+			if (IsCellInRange(Cell))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				const FIntVector Cell(X, Y, Z);
+				if (ListenerCells.Contains(Cell) && IsCellInRange(Cell))
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
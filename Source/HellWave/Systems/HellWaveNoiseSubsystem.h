@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GenericTeamAgentInterface.h"
+#include "HellWaveNoiseSubsystem.generated.h"
+
+class UHellWaveNoiseGraphData;
+class UAIPerceptionComponent;
+
+/**
+ *  Aggregates AI hearing noise events for a frame before handing them to perception
+ *  Noises from the same instigator with the same tag that land close together are merged into one
+ *  Hearing listeners are bucketed into a coarse grid, and merged noises that can't reach
+ *  any occupied cell are dropped before they fan out to every listener
+ *  Levels with a baked noise graph propagate noise from room to room instead, by travel distance
+ *  through portals, and listeners in another room hear it at the portal it came through
+ *  Listeners outside every room hear room noises through the nearest portal of the noise's room
+ *  Flushed by UHellWaveEndOfFrameSubsystem, after damage and impulses
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UHellWaveNoiseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Noises from the same instigator and tag within the same cell of this size are merged */
+	UPROPERTY(Config)
+	float MergeCellSize = 300.0f;
+
+	/** Size of the grid cells listeners are bucketed into */
+	UPROPERTY(Config)
+	float ListenerCellSize = 2000.0f;
+
+	/** Longest hearing range of any listener. Noises reach this far scaled by loudness, capped by their max range */
+	UPROPERTY(Config)
+	float HearingRange = 6000.0f;
+
+	/** Noises from one instigator and tag in one cell */
+	struct FNoiseKey
+	{
+		const AActor* Instigator;
+		FName Tag;
+		FIntVector Cell;
+
+		bool operator==(const FNoiseKey& Other) const { return Instigator == Other.Instigator && Tag == Other.Tag && Cell == Other.Cell; }
+		friend uint32 GetTypeHash(const FNoiseKey& Key) { return HashCombineFast(HashCombineFast(GetTypeHash(Key.Instigator), GetTypeHash(Key.Tag)), GetTypeHash(Key.Cell)); }
+	};
+
+	/** A merged noise waiting for the end of frame flush */
+	struct FNoiseEvent
+	{
+		/** The instigator can be destroyed before the flush */
+		TWeakObjectPtr<AActor> Instigator;
+
+		/** Location sum, averaged on flush */
+		FVector LocationSum = FVector::ZeroVector;
+		int32 Count = 0;
+
+		/** Loudest and farthest reaching of the merged noises */
+		float Loudness = 0.0f;
+		float MaxRange = 0.0f;
+
+		FName Tag;
+	};
+
+	/** Noises reported this frame */
+	TArray<FNoiseEvent> PendingNoises;
+
+	/** Index of each merged noise in PendingNoises */
+	TMap<FNoiseKey, int32> PendingNoiseIndices;
+
+	/** Cells holding at least one hearing listener, rebuilt on flush */
+	TSet<FIntVector> ListenerCells;
+
+	/** Room and portal graph for the loaded level, if any */
+	UPROPERTY(Transient)
+	TObjectPtr<UHellWaveNoiseGraphData> NoiseGraph;
+
+	/** A hearing listener, bucketed by noise graph room */
+	struct FRoomListener
+	{
+		TWeakObjectPtr<UAIPerceptionComponent> Perception;
+		const AActor* Body;
+		FVector Location;
+		FGenericTeamId TeamId;
+		float HearingRange;
+		uint8 AffiliationFlags;
+		int32 Room;
+	};
+
+	/** Hearing listeners sorted by room, rebuilt on flush when there's a noise graph */
+	TArray<FRoomListener> RoomListeners;
+
+public:
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Reports a noise for AI hearing. Same arguments as AActor::MakeNoise */
+	void ReportNoise(float Loudness, AActor* Instigator, const FVector& Location, float MaxRange = 0.0f, FName Tag = NAME_None);
+
+	/** Sets the noise graph for the loaded level */
+	void SetNoiseGraph(UHellWaveNoiseGraphData* InNoiseGraph);
+
+	/** Clears the noise graph if it matches the passed asset */
+	void ClearNoiseGraph(UHellWaveNoiseGraphData* InNoiseGraph);
+
+	/** Delivers the merged noises to the listeners that can hear them */
+	void FlushNoises();
+
+protected:
+
+	/** Buckets the hearing listeners into grid cells, and into noise graph rooms if there's a graph */
+	void GatherListeners();
+
+	/** Delivers a noise that started in a noise graph room to every listener it can reach through the graph. Returns false if the noise has no instigator to register stimuli for */
+	bool PropagateNoise(const FNoiseEvent& Noise, const FVector& Location, int32 NoiseRoom);
+
+	/** Returns true if an occupied listener cell is within range of the location */
+	bool IsListenerCellInRange(const FVector& Location, float Range) const;
+};
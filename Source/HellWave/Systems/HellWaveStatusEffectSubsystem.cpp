@@ -0,0 +1,320 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveStatusEffectSubsystem.h"
+#include "HellWaveTeamComponent.h"
+#include "HellWaveDamageSubsystem.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Status Effect Update"), STAT_HellWaveStatusEffectUpdate, STATGROUP_HellWave);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Status Effects Active"), STAT_HellWaveStatusEffectsActive, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Status Damage Applied"), STAT_HellWaveStatusDamageApplied, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Status Change Events"), STAT_HellWaveStatusChangeEvents, STATGROUP_HellWave);
+
+namespace
+{
+	constexpr int32 NumEffectTypes = static_cast<int32>(EHellWaveStatusEffect::Count);
+
+	/** Team state flag raised while each effect type is active */
+	constexpr EHellWaveActorState EffectStates[NumEffectTypes] =
+	{
+		EHellWaveActorState::Burning
+	};
+}
+
+bool UHellWaveStatusEffectSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHellWaveStatusEffectSubsystem::UpdateEffects(float DeltaTime)
+{
+	if (Entities.Num() == FreeEntities.Num())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveStatusEffectUpdate);
+
+	const int32 NumEffects = EffectEntities.Num();
+	const float TickInterval = FMath::Max(DamageTickInterval, UE_KINDA_SMALL_NUMBER);
+
+	EffectDamage.SetNumUninitialized(NumEffects, EAllowShrinking::No);
+
+	// Each effect only touches its own elements, so ranges can run on any thread
+	auto AdvanceEffects = [this, DeltaTime, TickInterval](int32 Begin, int32 End)
+	{
+		for (int32 EffectIndex = Begin; EffectIndex < End; ++EffectIndex)
+		{
+			// Don't tick past the end of the effect
+			const float ActiveTime = FMath::Clamp(EffectRemainingTimes[EffectIndex], 0.0f, DeltaTime);
+			EffectRemainingTimes[EffectIndex] -= DeltaTime;
+
+			float& Accumulator = EffectTickAccumulators[EffectIndex];
+			Accumulator += ActiveTime;
+
+			const int32 NumTicks = FMath::FloorToInt32(Accumulator / TickInterval);
+			Accumulator -= NumTicks * TickInterval;
+
+			EffectDamage[EffectIndex] = NumTicks * TickInterval * EffectMagnitudes[EffectIndex];
+		}
+	};
+
+	if (NumEffects >= MinEffectsForParallelUpdate)
+	{
+		const int32 BatchSize = FMath::Max(ParallelBatchSize, 1);
+		const int32 NumBatches = FMath::DivideAndRoundUp(NumEffects, BatchSize);
+
+		ParallelFor(NumBatches, [&AdvanceEffects, BatchSize, NumEffects](int32 BatchIndex)
+		{
+			const int32 Begin = BatchIndex * BatchSize;
+			AdvanceEffects(Begin, FMath::Min(Begin + BatchSize, NumEffects));
+		});
+	}
+	else
+	{
+		AdvanceEffects(0, NumEffects);
+	}
+
+	// Sum the damage per entity so each actor takes one hit per frame
+	for (int32 EffectIndex = 0; EffectIndex < NumEffects; ++EffectIndex)
+	{
+		if (EffectDamage[EffectIndex] > 0.0f)
+		{
+			const int32 Entity = EffectEntities[EffectIndex];
+			EntityDamage[Entity] += EffectDamage[EffectIndex];
+
+			if (EffectInstigators[EffectIndex].IsValid())
+			{
+				EntityInstigators[Entity] = EffectInstigators[EffectIndex];
+			}
+		}
+	}
+
+	// Drop expired effects. Walking backwards keeps the swapped in effects already visited
+	for (int32 EffectIndex = NumEffects - 1; EffectIndex >= 0; --EffectIndex)
+	{
+		if (EffectRemainingTimes[EffectIndex] <= 0.0f || !Entities[EffectEntities[EffectIndex]].IsValid())
+		{
+			RemoveEffectAt(EffectIndex);
+		}
+	}
+
+	FlushEntities();
+
+	SET_DWORD_STAT(STAT_HellWaveStatusEffectsActive, EffectEntities.Num());
+}
+
+void UHellWaveStatusEffectSubsystem::ApplyEffect(AActor* Target, EHellWaveStatusEffect Type, float Duration, float Magnitude, AController* Instigator)
+{
+	if (!IsValid(Target) || Duration <= 0.0f || Type >= EHellWaveStatusEffect::Count)
+	{
+		return;
+	}
+
+	// The dead don't burn
+	if (const UHellWaveTeamComponent* Team = UHellWaveTeamComponent::FindTeamComponent(Target))
+	{
+		if (Team->IsDead())
+		{
+			return;
+		}
+	}
+
+	const int32 Entity = FindOrAddEntity(Target);
+	int32& Slot = EffectSlots[Entity * NumEffectTypes + static_cast<int32>(Type)];
+
+	// Refresh an active effect instead of stacking a second one
+	if (Slot != INDEX_NONE)
+	{
+		EffectRemainingTimes[Slot] = FMath::Max(EffectRemainingTimes[Slot], Duration);
+		EffectMagnitudes[Slot] = FMath::Max(EffectMagnitudes[Slot], Magnitude);
+
+		if (Instigator)
+		{
+			EffectInstigators[Slot] = Instigator;
+		}
+
+		return;
+	}
+
+	Slot = EffectEntities.Add(Entity);
+	EffectTypes.Add(Type);
+	EffectRemainingTimes.Add(Duration);
+	EffectTickAccumulators.Add(0.0f);
+	EffectMagnitudes.Add(Magnitude);
+	EffectInstigators.Add(Instigator);
+}
+
+void UHellWaveStatusEffectSubsystem::RemoveEffect(AActor* Target, EHellWaveStatusEffect Type)
+{
+	if (Type >= EHellWaveStatusEffect::Count)
+	{
+		return;
+	}
+
+	if (const int32* Entity = EntityLookup.Find(TObjectKey<AActor>(Target)))
+	{
+		const int32 Slot = EffectSlots[*Entity * NumEffectTypes + static_cast<int32>(Type)];
+		if (Slot != INDEX_NONE)
+		{
+			RemoveEffectAt(Slot);
+		}
+	}
+}
+
+bool UHellWaveStatusEffectSubsystem::HasEffect(const AActor* Target, EHellWaveStatusEffect Type) const
+{
+	if (Type >= EHellWaveStatusEffect::Count)
+	{
+		return false;
+	}
+
+	const int32* Entity = EntityLookup.Find(TObjectKey<AActor>(Target));
+	return Entity && EffectSlots[*Entity * NumEffectTypes + static_cast<int32>(Type)] != INDEX_NONE;
+}
+
+int32 UHellWaveStatusEffectSubsystem::FindOrAddEntity(AActor* Actor)
+{
+	if (const int32* Entity = EntityLookup.Find(TObjectKey<AActor>(Actor)))
+	{
+		return *Entity;
+	}
+
+	int32 Entity = INDEX_NONE;
+
+	if (FreeEntities.Num() > 0)
+	{
+		Entity = FreeEntities.Pop(EAllowShrinking::No);
+		Entities[Entity] = Actor;
+		EntityKeys[Entity] = Actor;
+	}
+	else
+	{
+		Entity = Entities.Add(Actor);
+		EntityKeys.Add(Actor);
+
+		for (int32 Type = 0; Type < NumEffectTypes; ++Type)
+		{
+			EffectSlots.Add(INDEX_NONE);
+		}
+
+		EntityMasks.Add(0);
+		EntityDamage.Add(0.0f);
+		EntityInstigators.AddDefaulted();
+	}
+
+	EntityLookup.Add(TObjectKey<AActor>(Actor), Entity);
+	return Entity;
+}
+
+void UHellWaveStatusEffectSubsystem::RemoveEffectAt(int32 EffectIndex)
+{
+	EffectSlots[EffectEntities[EffectIndex] * NumEffectTypes + static_cast<int32>(EffectTypes[EffectIndex])] = INDEX_NONE;
+
+	// The last effect moves into the freed index
+	const int32 LastIndex = EffectEntities.Num() - 1;
+	if (EffectIndex != LastIndex)
+	{
+		EffectSlots[EffectEntities[LastIndex] * NumEffectTypes + static_cast<int32>(EffectTypes[LastIndex])] = EffectIndex;
+	}
+
+	EffectEntities.RemoveAtSwap(EffectIndex, EAllowShrinking::No);
+	EffectTypes.RemoveAtSwap(EffectIndex, EAllowShrinking::No);
+	EffectRemainingTimes.RemoveAtSwap(EffectIndex, EAllowShrinking::No);
+	EffectTickAccumulators.RemoveAtSwap(EffectIndex, EAllowShrinking::No);
+	EffectMagnitudes.RemoveAtSwap(EffectIndex, EAllowShrinking::No);
+	EffectInstigators.RemoveAtSwap(EffectIndex, EAllowShrinking::No);
+}
+
+void UHellWaveStatusEffectSubsystem::FlushEntities()
+{
+	UHellWaveDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UHellWaveDamageSubsystem>();
+
+	// Damage can kill actors and start new effects, so entities are read by index every step
+	for (int32 Entity = 0; Entity < Entities.Num(); ++Entity)
+	{
+		// Skip free slots
+		if (EntityKeys[Entity] == TObjectKey<AActor>())
+		{
+			continue;
+		}
+
+		AActor* Actor = Entities[Entity].Get();
+
+		// Queue this frame's damage over time as one hit
+		if (Actor && DamageSubsystem && EntityDamage[Entity] > 0.0f)
+		{
+			AController* Instigator = EntityInstigators[Entity].Get();
+			DamageSubsystem->QueueDamage(Actor, EntityDamage[Entity], Instigator, Instigator ? Instigator->GetPawn() : nullptr, DamageOverTimeType);
+
+			INC_DWORD_STAT(STAT_HellWaveStatusDamageApplied);
+		}
+
+		EntityDamage[Entity] = 0.0f;
+		EntityInstigators[Entity].Reset();
+
+		// Effects end with the actor
+		UHellWaveTeamComponent* Team = IsValid(Actor) ? UHellWaveTeamComponent::FindTeamComponent(Actor) : nullptr;
+		const bool bEndEffects = !IsValid(Actor) || (Team && Team->IsDead());
+
+		uint8 NewMask = 0;
+
+		for (int32 Type = 0; Type < NumEffectTypes; ++Type)
+		{
+			const int32 Slot = EffectSlots[Entity * NumEffectTypes + Type];
+			if (Slot == INDEX_NONE)
+			{
+				continue;
+			}
+
+			if (bEndEffects)
+			{
+				RemoveEffectAt(Slot);
+			}
+			else
+			{
+				NewMask |= 1 << Type;
+			}
+		}
+
+		// Actors only hear about effects starting and ending
+		const uint8 OldMask = EntityMasks[Entity];
+		if (NewMask != OldMask && IsValid(Actor))
+		{
+			EntityMasks[Entity] = NewMask;
+
+			// A dead actor's state was already reset when it died
+			if (Team && !Team->IsDead())
+			{
+				for (int32 Type = 0; Type < NumEffectTypes; ++Type)
+				{
+					if (NewMask & (1 << Type))
+					{
+						Team->AddState(EffectStates[Type]);
+					}
+					else
+					{
+						Team->RemoveState(EffectStates[Type]);
+					}
+				}
+			}
+
+			OnStatusEffectsChanged.Broadcast(Actor, OldMask, NewMask);
+			INC_DWORD_STAT(STAT_HellWaveStatusChangeEvents);
+		}
+
+		// Free the entity once it has nothing left running
+		if (NewMask == 0)
+		{
+			EntityMasks[Entity] = 0;
+			EntityLookup.Remove(EntityKeys[Entity]);
+			EntityKeys[Entity] = TObjectKey<AActor>();
+			Entities[Entity].Reset();
+			FreeEntities.Add(Entity);
+		}
+	}
+}
@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HellWaveStatusEffectSubsystem.generated.h"
+
+class AController;
+class UDamageType;
+
+/**
+ *  Types of status effect
+ */
+UENUM(BlueprintType)
+enum class EHellWaveStatusEffect : uint8
+{
+	Burning,
+
+	Count UMETA(Hidden)
+};
+
+/** Called when the set of effects visibly active on an actor changes. Masks hold one bit per effect type */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FHellWaveStatusEffectsChangedDelegate, AActor* /*Actor*/, uint8 /*OldMask*/, uint8 /*NewMask*/);
+
+/**
+ *  Runs every active status effect in the world from one place
+ *  Effects are stored as structure of arrays and advanced in a single loop per frame,
+ *  split across worker threads when there are enough of them
+ *  Damage over time is summed per actor and queued once per frame
+ *  Advanced by UHellWaveEndOfFrameSubsystem, just before damage resolves
+ *  Actors only hear about effects starting and ending, through the team state flags and OnStatusEffectsChanged
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UHellWaveStatusEffectSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Time between damage over time ticks */
+	UPROPERTY(Config)
+	float DamageTickInterval = 0.5f;
+
+	/** Minimum number of active effects before the update is split across worker threads */
+	UPROPERTY(Config)
+	int32 MinEffectsForParallelUpdate = 256;
+
+	/** Number of effects each worker task advances */
+	UPROPERTY(Config)
+	int32 ParallelBatchSize = 128;
+
+	/** Damage type used for damage over time */
+	UPROPERTY(Config)
+	TSubclassOf<UDamageType> DamageOverTimeType;
+
+	/** Actors with effects, indexed by entity. Freed slots are reused */
+	TArray<TWeakObjectPtr<AActor>> Entities;
+
+	/** Lookup key of each entity's actor. Unset for free slots */
+	TArray<TObjectKey<AActor>> EntityKeys;
+
+	/** Entity slots free for reuse */
+	TArray<int32> FreeEntities;
+
+	/** Entity index of each actor with effects */
+	TMap<TObjectKey<AActor>, int32> EntityLookup;
+
+	/** Index of the active effect of each type on each entity, indexed [Entity * NumTypes + Type]. INDEX_NONE if inactive */
+	TArray<int32> EffectSlots;
+
+	/** Effect types visibly active on each entity as of the last update */
+	TArray<uint8> EntityMasks;
+
+	/** Damage summed for each entity this frame */
+	TArray<float> EntityDamage;
+
+	/** Controller credited for each entity's damage this frame */
+	TArray<TWeakObjectPtr<AController>> EntityInstigators;
+
+	/** Active effects, one element per effect in each array */
+	TArray<int32> EffectEntities;
+	TArray<EHellWaveStatusEffect> EffectTypes;
+	TArray<float> EffectRemainingTimes;
+	TArray<float> EffectTickAccumulators;
+
+	/** Damage per second for damage over time effects */
+	TArray<float> EffectMagnitudes;
+
+	/** Controller credited for the effect's damage */
+	TArray<TWeakObjectPtr<AController>> EffectInstigators;
+
+	/** Damage each effect dealt this frame, written by the update loop */
+	TArray<float> EffectDamage;
+
+public:
+
+	/** Fired when the set of effects on an actor changes */
+	FHellWaveStatusEffectsChangedDelegate OnStatusEffectsChanged;
+
+	/** Only runs in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Advances every active effect and queues their damage. Called by the end of frame subsystem before the frame's damage resolves */
+	void UpdateEffects(float DeltaTime);
+
+	/**
+	 *  Applies an effect to an actor for a duration
+	 *  Reapplying an active effect keeps the longer duration and the stronger magnitude
+	 *  Magnitude is damage per second for damage over time effects
+	 */
+	void ApplyEffect(AActor* Target, EHellWaveStatusEffect Type, float Duration, float Magnitude = 0.0f, AController* Instigator = nullptr);
+
+	/** Ends an effect on an actor early */
+	void RemoveEffect(AActor* Target, EHellWaveStatusEffect Type);
+
+	/** Returns true if the effect is active on the actor */
+	bool HasEffect(const AActor* Target, EHellWaveStatusEffect Type) const;
+
+	/** Returns the number of active effects */
+	int32 GetNumActiveEffects() const { return EffectEntities.Num(); }
+
+protected:
+
+	/** Returns the entity index for an actor, adding it if needed */
+	int32 FindOrAddEntity(AActor* Actor);
+
+	/** Removes an effect, swapping the last effect into its place */
+	void RemoveEffectAt(int32 EffectIndex);
+
+	/** Queues the summed damage, raises change events and frees entities with no effects left */
+	void FlushEntities();
+};
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveStateTreeTactics.h"
+#include "StateTreeExecutionContext.h"
+#include "HellWaveArenaDataSubsystem.h"
+#include "ShooterNPC.h"
+#include "Engine/World.h"
+
+EStateTreeRunStatus FStateTreeChooseTacticalPositionTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned from another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		if (!IsValid(InstanceData.Character) || !IsValid(InstanceData.Target))
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
+		// get the baked arena data
+		const UHellWaveArenaDataSubsystem* ArenaData = InstanceData.Character->GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>();
+		const UHellWaveArenaBakeData* BakeData = ArenaData ? ArenaData->GetBakeData() : nullptr;
+
+		if (!BakeData)
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
+		// score the graph against the target's zone
+		const int32 NodeIndex = BakeData->SelectTacticalNode(InstanceData.Target->GetActorLocation(), InstanceData.Character->GetActorLocation(), InstanceData.Scoring);
+
+		if (NodeIndex == INDEX_NONE)
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
+		// set the task outputs
+		const FHellWaveTacticalNode& Node = BakeData->TacticalNodes[NodeIndex];
+		InstanceData.OutLocation = Node.Location;
+		InstanceData.OutFlags = Node.Flags;
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+#if WITH_EDITOR
+FText FStateTreeChooseTacticalPositionTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Choose Tactical Position</b>");
+}
+#endif // WITH_EDITOR
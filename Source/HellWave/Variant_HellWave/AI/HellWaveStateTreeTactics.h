@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeTaskBase.h"
+#include "HellWaveArenaBakeData.h"
+
+#include "HellWaveStateTreeTactics.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Instance data struct for the Choose Tactical Position StateTree task
+ */
+USTRUCT()
+struct FStateTreeChooseTacticalPositionInstanceData
+{
+	GENERATED_BODY()
+
+	/** NPC choosing a position */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterNPC> Character;
+
+	/** Actor to position against */
+	UPROPERTY(EditAnywhere, Category = Input)
+	TObjectPtr<AActor> Target;
+
+	/** Weights used to score the baked tactical nodes */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	FHellWaveTacticalScoring Scoring;
+
+	/** Chosen position */
+	UPROPERTY(EditAnywhere, Category = Output)
+	FVector OutLocation = FVector::ZeroVector;
+
+	/** Tactical flags of the chosen position */
+	UPROPERTY(EditAnywhere, Category = Output, meta = (Bitmask, BitmaskEnum = "/Script/HellWave.EHellWaveTacticalFlags"))
+	uint8 OutFlags = 0;
+};
+
+/**
+ *  StateTree task that picks a position from the arena's baked tactical graph
+ *  Scores every node against the target's current zone in a single table scan
+ *  Fails if the arena has no tactical bake or no node qualifies, so the tree can fall back to EQS
+ */
+USTRUCT(meta=(DisplayName="Choose Tactical Position", Category="HellWave"))
+struct FStateTreeChooseTacticalPositionTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeChooseTacticalPositionInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
@@ -2,13 +2,19 @@
 
 #include "HellWaveArenaCharacter.h"
 #include "HellWaveDashComponent.h"
+#include "HellWaveTeamComponent.h"
+#include "HellWaveStatusEffectSubsystem.h"
+#include "HellWaveActorRegistrySubsystem.h"
+#include "HellWaveDamageSubsystem.h"
+#include "HellWaveGloryKillDamageType.h"
+#include "HellWaveChainsawDamageType.h"
 #include "HellWaveEnemy.h"
 #include "HellWaveWeapon.h"
 #include "EnhancedInputComponent.h"
 #include "InputActionValue.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
 #include "Camera/CameraComponent.h"
-#include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
@@ -33,6 +39,12 @@ void AHellWaveArenaCharacter::BeginPlay()
 	JumpsRemaining = ExtraJumps;
 	CurrentChainsawFuel = MaxChainsawFuel;
 	bFlameBelchReady = true;
+
+	// Index enemies so abilities can find targets without iterating the world
+	if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
+	{
+		Registry->TrackClass(AHellWaveEnemy::StaticClass());
+	}
 }
 
 void AHellWaveArenaCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -100,7 +112,8 @@ void AHellWaveArenaCharacter::SetupPlayerInputComponent(UInputComponent* PlayerI
 
 float AHellWaveArenaCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	if (bIsInvulnerable || IsDead())
+	// Teammates don't chip away at armor either
+	if (bIsInvulnerable || IsDead() || GetTeamComponent()->ShouldIgnoreDamageFrom(EventInstigator ? EventInstigator->GetPawn() : DamageCauser))
 	{
 		return 0.0f;
 	}
@@ -172,8 +185,11 @@ void AHellWaveArenaCharacter::DoGloryKill()
 	bIsInvulnerable = true;
 	GetWorld()->GetTimerManager().SetTimer(InvulnTimer, this, &AHellWaveArenaCharacter::EndInvulnerability, GloryKillInvulnTime, false);
 
-	// Kill the enemy via glory kill
-	Target->OnGloryKilled();
+	// Kill the enemy via glory kill in this frame's damage pass, so it can't also die to a hit landed this frame
+	if (UHellWaveDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UHellWaveDamageSubsystem>())
+	{
+		DamageSubsystem->QueueFinisher(Target, GetController(), this, UHellWaveGloryKillDamageType::StaticClass());
+	}
 
 	// Restore health
 	AddHealth(GloryKillHealthRestore);
@@ -190,8 +206,11 @@ void AHellWaveArenaCharacter::DoChainsaw()
 	--CurrentChainsawFuel;
 	OnChainsawFuelUpdated.Broadcast(CurrentChainsawFuel);
 
-	// Kill the enemy via chainsaw
-	Target->OnChainsawKilled();
+	// Kill the enemy via chainsaw in this frame's damage pass
+	if (UHellWaveDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UHellWaveDamageSubsystem>())
+	{
+		DamageSubsystem->QueueFinisher(Target, GetController(), this, UHellWaveChainsawDamageType::StaticClass());
+	}
 
 	// Restore ammo to all weapons
 	AddAmmoToAllWeapons(ChainsawAmmoRestore);
@@ -208,14 +227,17 @@ void AHellWaveArenaCharacter::DoFlameBelch()
 
 	// Find enemies in cone and apply burning
 	const FVector Origin = GetActorLocation();
-	const FVector Forward = GetFirstPersonCameraComponent()->GetForwardVector();
+	const FVector Forward = GetAimContext().CameraDirection;
 
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AHellWaveEnemy::StaticClass(), FoundActors);
+	UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>();
+	if (!Registry) return;
 
-	for (AActor* Actor : FoundActors)
+	UHellWaveStatusEffectSubsystem* StatusEffects = GetWorld()->GetSubsystem<UHellWaveStatusEffectSubsystem>();
+	const float ConeThreshold = FMath::Cos(FMath::DegreesToRadians(FlameBelchHalfAngle));
+
+	for (const TWeakObjectPtr<AActor>& Actor : Registry->GetActorsOfClass(AHellWaveEnemy::StaticClass()))
 	{
-		AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Actor);
+		AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Actor.Get());
 		if (!Enemy || Enemy->IsEnemyDead()) continue;
 
 		const FVector ToEnemy = Enemy->GetActorLocation() - Origin;
@@ -224,10 +246,16 @@ void AHellWaveArenaCharacter::DoFlameBelch()
 
 		// Check cone angle
 		const float DotProduct = FVector::DotProduct(Forward, ToEnemy.GetSafeNormal());
-		const float ConeThreshold = FMath::Cos(FMath::DegreesToRadians(FlameBelchHalfAngle));
 		if (DotProduct >= ConeThreshold)
 		{
+			// The enemy still owns its burn damage and visuals until it reacts to the Burning state itself
 			Enemy->ApplyBurning(FlameBelchBurnDuration);
+
+			// Raise the Burning state so other systems can see it, without dealing the damage twice
+			if (StatusEffects)
+			{
+				StatusEffects->ApplyEffect(Enemy, EHellWaveStatusEffect::Burning, FlameBelchBurnDuration);
+			}
 		}
 	}
 }
@@ -308,15 +336,15 @@ AHellWaveEnemy* AHellWaveArenaCharacter::FindGloryKillTarget() const
 {
 	const FVector Origin = GetActorLocation();
 
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AHellWaveEnemy::StaticClass(), FoundActors);
+	UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>();
+	if (!Registry) return nullptr;
 
 	AHellWaveEnemy* ClosestTarget = nullptr;
 	float ClosestDistance = GloryKillRange;
 
-	for (AActor* Actor : FoundActors)
+	for (const TWeakObjectPtr<AActor>& Actor : Registry->GetActorsOfClass(AHellWaveEnemy::StaticClass()))
 	{
-		AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Actor);
+		AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Actor.Get());
 		if (!Enemy || !Enemy->IsStaggered()) continue;
 
 		const float Distance = FVector::Dist(Origin, Enemy->GetActorLocation());
@@ -334,15 +362,15 @@ AHellWaveEnemy* AHellWaveArenaCharacter::FindChainsawTarget() const
 {
 	const FVector Origin = GetActorLocation();
 
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AHellWaveEnemy::StaticClass(), FoundActors);
+	UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>();
+	if (!Registry) return nullptr;
 
 	AHellWaveEnemy* ClosestTarget = nullptr;
 	float ClosestDistance = ChainsawRange;
 
-	for (AActor* Actor : FoundActors)
+	for (const TWeakObjectPtr<AActor>& Actor : Registry->GetActorsOfClass(AHellWaveEnemy::StaticClass()))
 	{
-		AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Actor);
+		AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Actor.Get());
 		if (!Enemy || Enemy->IsEnemyDead()) continue;
 
 		const float Distance = FVector::Dist(Origin, Enemy->GetActorLocation());
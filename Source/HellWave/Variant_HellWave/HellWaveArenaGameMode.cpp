@@ -2,9 +2,29 @@
 
 #include "HellWaveArenaGameMode.h"
 #include "HellWaveWaveManager.h"
+#include "HellWaveActorRegistrySubsystem.h"
+#include "HellWaveArenaDataSubsystem.h"
+#include "ShooterNPC.h"
+#include "ShooterProjectile.h"
+#include "ShooterPickup.h"
+#include "ShooterCharacter.h"
+#include "HellWaveArenaPlayerController.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Sound/SoundBase.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/Texture.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Animation/AnimSequenceBase.h"
+#include "UObject/UObjectHash.h"
+#include "HellWave.h"
 #include "Kismet/GameplayStatics.h"
-#include "EngineUtils.h"
+#include "Engine/Engine.h"
 #include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/UObjectGlobals.h"
 #include "TimerManager.h"
 
 AHellWaveArenaGameMode::AHellWaveArenaGameMode()
@@ -16,19 +36,33 @@ void AHellWaveArenaGameMode::BeginPlay()
 	Super::BeginPlay();
 
 	// Create the wave manager
-	if (WaveManagerClass)
+	CreateWaveManager();
+
+	if (WaveManager)
 	{
-		WaveManager = NewObject<UHellWaveWaveManager>(this, WaveManagerClass);
+		// Start waves after delay
+		GetWorld()->GetTimerManager().SetTimer(StartDelayTimer, this, &AHellWaveArenaGameMode::OnStartDelayComplete, StartDelay, false);
+	}
 
-		// Gather spawn points
-		TArray<AActor*> SpawnPoints = GatherSpawnPoints();
-		WaveManager->Initialize(GetWorld(), SpawnPoints);
+	// Baseline for the prewarm memory report
+	LogResidentAssetMemory(TEXT("arena start"));
 
-		// Subscribe to wave state changes
-		WaveManager->OnWaveStateChanged.AddDynamic(this, &AHellWaveArenaGameMode::OnWaveStateChanged);
+	// Prewarm once every actor has begun play
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &AHellWaveArenaGameMode::PrewarmArena);
 
-		// Start waves after delay
-		GetWorld()->GetTimerManager().SetTimer(StartDelayTimer, this, &AHellWaveArenaGameMode::OnStartDelayComplete, StartDelay, false);
+	if (bManageGarbageCollection)
+	{
+		// Index NPCs so wave intermissions can be detected without iterating the world
+		if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
+		{
+			Registry->TrackClass(AShooterNPC::StaticClass());
+		}
+
+		PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &AHellWaveArenaGameMode::OnPreGarbageCollect);
+		PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &AHellWaveArenaGameMode::OnPostGarbageCollect);
+
+		// Purge level load garbage during the start delay, before any fighting
+		GEngine->ForceGarbageCollection(true);
 	}
 }
 
@@ -36,6 +70,55 @@ void AHellWaveArenaGameMode::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 	GetWorld()->GetTimerManager().ClearTimer(StartDelayTimer);
+	GetWorld()->GetTimerManager().ClearTimer(CombatGCTimer);
+
+	// Stop any prewarm still streaming
+	if (PrewarmClassesHandle.IsValid())
+	{
+		PrewarmClassesHandle->CancelHandle();
+	}
+
+	if (PrewarmDependenciesHandle.IsValid())
+	{
+		PrewarmDependenciesHandle->CancelHandle();
+	}
+
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+
+	ReportWaveGC();
+}
+
+void AHellWaveArenaGameMode::CreateWaveManager()
+{
+	if (!WaveManagerClass)
+	{
+		return;
+	}
+
+	WaveManager = NewObject<UHellWaveWaveManager>(this, WaveManagerClass);
+
+	// Gather spawn points
+	TArray<AActor*> SpawnPoints = GatherSpawnPoints();
+	WaveManager->Initialize(GetWorld(), SpawnPoints);
+
+	// Subscribe to wave state changes
+	WaveManager->OnWaveStateChanged.AddDynamic(this, &AHellWaveArenaGameMode::OnWaveStateChanged);
+}
+
+void AHellWaveArenaGameMode::ReleaseWaveManager()
+{
+	if (!WaveManager)
+	{
+		return;
+	}
+
+	WaveManager->OnWaveStateChanged.RemoveDynamic(this, &AHellWaveArenaGameMode::OnWaveStateChanged);
+
+	// Make sure nothing the old manager scheduled fires into the new run
+	GetWorld()->GetTimerManager().ClearAllTimersForObject(WaveManager);
+
+	WaveManager = nullptr;
 }
 
 void AHellWaveArenaGameMode::OnStartDelayComplete()
@@ -50,19 +133,59 @@ TArray<AActor*> AHellWaveArenaGameMode::GatherSpawnPoints() const
 {
 	TArray<AActor*> SpawnPoints;
 
-	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
 	{
-		if (It->Tags.Contains(SpawnPointTag))
+		// tracking the tag indexes current and streamed in spawn points
+		Registry->TrackTag(SpawnPointTag);
+
+		for (const TWeakObjectPtr<AActor>& SpawnPoint : Registry->GetActorsWithTag(SpawnPointTag))
 		{
-			SpawnPoints.Add(*It);
+			if (AActor* SpawnPointActor = SpawnPoint.Get())
+			{
+				SpawnPoints.Add(SpawnPointActor);
+			}
 		}
 	}
 
 	return SpawnPoints;
 }
 
+bool AHellWaveArenaGameMode::HasLivingEnemies() const
+{
+	if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : Registry->GetActorsOfClass(AShooterNPC::StaticClass()))
+		{
+			const AShooterNPC* NPC = Cast<AShooterNPC>(Actor.Get());
+			if (NPC && !NPC->IsDead())
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void AHellWaveArenaGameMode::OnWaveStateChanged(EHellWaveState NewState, int32 WaveNumber)
 {
+	if (bManageGarbageCollection)
+	{
+		// A new wave number means a wave is starting. The same wave with nothing left alive means it's been cleared
+		if (NewState == EHellWaveState::Victory || NewState == EHellWaveState::Defeat)
+		{
+			BeginIntermissionGC();
+		}
+		else if (WaveNumber > GCReportWave)
+		{
+			BeginCombatGC(WaveNumber);
+		}
+		else if (!HasLivingEnemies())
+		{
+			BeginIntermissionGC();
+		}
+	}
+
 	// This is where the GameMode can react to wave changes
 	// Blueprint can also bind to the WaveManager's delegate directly
 	switch (NewState)
@@ -87,3 +210,397 @@ void AHellWaveArenaGameMode::NotifyPlayerDeath()
 		WaveManager->OnPlayerDied();
 	}
 }
+
+TArray<FTransform> AHellWaveArenaGameMode::SelectSpawnTransforms(int32 Count) const
+{
+	TArray<FTransform> SpawnTransforms;
+
+	const UHellWaveArenaDataSubsystem* ArenaData = GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>();
+	const UHellWaveArenaBakeData* BakeData = ArenaData ? ArenaData->GetBakeData() : nullptr;
+
+	if (!BakeData)
+	{
+		return SpawnTransforms;
+	}
+
+	// Score against the player, or the origin before a pawn exists
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	const FVector PlayerLocation = PlayerPawn ? PlayerPawn->GetActorLocation() : FVector::ZeroVector;
+
+	BakeData->SelectSpawnTransforms(PlayerLocation, Count, SpawnScoring, SpawnTransforms);
+
+	return SpawnTransforms;
+}
+
+void AHellWaveArenaGameMode::BeginCombatGC(int32 WaveNumber)
+{
+	// Report the previous wave if it never had an intermission
+	if (GCReportWave != WaveNumber)
+	{
+		ReportWaveGC();
+		GCReportWave = WaveNumber;
+	}
+
+	CombatGCDeferStartTime = FPlatformTime::Seconds();
+
+	DeferCombatGC();
+	GetWorld()->GetTimerManager().SetTimer(CombatGCTimer, this, &AHellWaveArenaGameMode::DeferCombatGC, CombatGCDeferInterval, true);
+}
+
+void AHellWaveArenaGameMode::BeginIntermissionGC()
+{
+	if (!GetWorld()->GetTimerManager().IsTimerActive(CombatGCTimer))
+	{
+		return;
+	}
+
+	GetWorld()->GetTimerManager().ClearTimer(CombatGCTimer);
+
+	ReportWaveGC();
+
+	// Collect everything the wave destroyed while nobody is fighting
+	GEngine->ForceGarbageCollection(true);
+}
+
+void AHellWaveArenaGameMode::DeferCombatGC()
+{
+	// Held off too long, so let an incremental pass through rather than risk a bigger one later
+	if (FPlatformTime::Seconds() - CombatGCDeferStartTime >= MaxCombatGCDeferral)
+	{
+		UE_LOG(LogHellWave, Verbose, TEXT("Wave %d held garbage collection for %.0fs, allowing an incremental pass."), GCReportWave, MaxCombatGCDeferral);
+
+		GEngine->ForceGarbageCollection(false);
+		CombatGCDeferStartTime = FPlatformTime::Seconds();
+		return;
+	}
+
+	// Keep the next collection out of reach until the next check
+	GEngine->SetTimeUntilNextGarbageCollection(CombatGCDeferInterval * 2.0f);
+}
+
+void AHellWaveArenaGameMode::ReportWaveGC()
+{
+	if (GCReportWave > 0)
+	{
+		UE_LOG(LogHellWave, Log, TEXT("Wave %d: %d garbage collections during combat, %.2f ms total, %.2f ms longest."), GCReportWave, WaveGCCount, WaveGCTime * 1000.0, WaveGCMaxTime * 1000.0);
+	}
+
+	WaveGCCount = 0;
+	WaveGCTime = 0.0;
+	WaveGCMaxTime = 0.0;
+}
+
+void AHellWaveArenaGameMode::OnPreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void AHellWaveArenaGameMode::OnPostGarbageCollect()
+{
+	const double GCTime = FPlatformTime::Seconds() - GCStartTime;
+
+	// Collections outside of a wave don't count against it
+	if (!GetWorld()->GetTimerManager().IsTimerActive(CombatGCTimer))
+	{
+		UE_LOG(LogHellWave, Log, TEXT("Garbage collection outside combat took %.2f ms."), GCTime * 1000.0);
+		return;
+	}
+
+	++WaveGCCount;
+	WaveGCTime += GCTime;
+	WaveGCMaxTime = FMath::Max(WaveGCMaxTime, GCTime);
+}
+
+void AHellWaveArenaGameMode::RestartArena()
+{
+	const double RestartStartTime = FPlatformTime::Seconds();
+
+	// Stop the current run
+	GetWorld()->GetTimerManager().ClearTimer(StartDelayTimer);
+	GetWorld()->GetTimerManager().ClearTimer(CombatGCTimer);
+	ReportWaveGC();
+	GCReportWave = 0;
+
+	// Stop listening to the old manager first, so the deaths below can't advance this run
+	if (WaveManager)
+	{
+		WaveManager->OnWaveStateChanged.RemoveDynamic(this, &AHellWaveArenaGameMode::OnWaveStateChanged);
+	}
+
+	// Reset the world state
+	ClearArenaActors();
+
+	// Release the manager only after its enemies are gone, so any timers their deaths scheduled are cleared too
+	ReleaseWaveManager();
+
+	ResetTeamScores();
+	ResetNPCSpawnIndex();
+	RestartArenaPlayers();
+
+	CreateWaveManager();
+
+	// The new pawns need their weapons parked again
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &AHellWaveArenaGameMode::PrewarmArena);
+
+	// Collect everything the old run left behind while the start delay hides it
+	if (bManageGarbageCollection)
+	{
+		GEngine->ForceGarbageCollection(true);
+	}
+
+	if (WaveManager)
+	{
+		GetWorld()->GetTimerManager().SetTimer(StartDelayTimer, this, &AHellWaveArenaGameMode::OnStartDelayComplete, StartDelay, false);
+	}
+
+	UE_LOG(LogHellWave, Log, TEXT("Arena restarted in place in %.2f ms."), (FPlatformTime::Seconds() - RestartStartTime) * 1000.0);
+}
+
+void AHellWaveArenaGameMode::ClearArenaActors()
+{
+	TArray<AActor*> ActorsToDestroy;
+
+	// Restarts are rare, so a single pass over the world is cheaper than tracking every projectile
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (AShooterNPC* NPC = Cast<AShooterNPC>(*It))
+		{
+			// NPC controllers outlive their pawns, so take them down too
+			if (AController* NPCController = NPC->GetController())
+			{
+				ActorsToDestroy.Add(NPCController);
+			}
+
+			ActorsToDestroy.Add(NPC);
+		}
+		else if (AShooterProjectile* Projectile = Cast<AShooterProjectile>(*It))
+		{
+			ActorsToDestroy.Add(Projectile);
+		}
+		else if (AShooterPickup* Pickup = Cast<AShooterPickup>(*It))
+		{
+			Pickup->ResetPickup();
+		}
+	}
+
+	// Weapons follow their owners out through OnOwnerDestroyed
+	for (AActor* Actor : ActorsToDestroy)
+	{
+		Actor->Destroy();
+	}
+}
+
+void AHellWaveArenaGameMode::RestartArenaPlayers()
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (!PC)
+		{
+			continue;
+		}
+
+		if (APawn* OldPawn = PC->GetPawn())
+		{
+			// Unhook the controller first, so losing this pawn isn't treated as a death or a respawn
+			OldPawn->OnDestroyed.RemoveAll(PC);
+
+			PC->UnPossess();
+			OldPawn->Destroy();
+		}
+
+		RestartPlayer(PC);
+	}
+}
+
+void AHellWaveArenaGameMode::PrewarmArena()
+{
+	PrewarmStartTime = FPlatformTime::Seconds();
+
+	// Every weapon the player can get, from the designer list and from pickups in the level
+	PendingPrewarmWeapons = PrewarmWeaponClasses;
+
+	for (TActorIterator<AShooterPickup> It(GetWorld()); It; ++It)
+	{
+		if (!It->GetWeaponClass().IsNull())
+		{
+			PendingPrewarmWeapons.AddUnique(It->GetWeaponClass());
+		}
+	}
+
+	TArray<FSoftObjectPath> AssetPaths;
+
+	for (const TSoftClassPtr<AShooterWeapon>& WeaponClass : PendingPrewarmWeapons)
+	{
+		if (!WeaponClass.IsNull())
+		{
+			AssetPaths.AddUnique(WeaponClass.ToSoftObjectPath());
+		}
+	}
+
+	if (!bPrewarmedSession)
+	{
+		for (const TSoftObjectPtr<UObject>& SoftAsset : PrewarmAssets)
+		{
+			if (!SoftAsset.IsNull())
+			{
+				AssetPaths.AddUnique(SoftAsset.ToSoftObjectPath());
+			}
+		}
+	}
+
+	if (AssetPaths.IsEmpty())
+	{
+		OnPrewarmClassesLoaded();
+		return;
+	}
+
+	// Stream the classes in while the start delay runs
+	PrewarmClassesHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths, FStreamableDelegate::CreateUObject(this, &AHellWaveArenaGameMode::OnPrewarmClassesLoaded));
+}
+
+void AHellWaveArenaGameMode::OnPrewarmClassesLoaded()
+{
+	// Weapons keep their projectiles, montages and anim classes as soft references, so stream those next
+	TArray<FSoftObjectPath> DependencyPaths;
+
+	for (const TSoftClassPtr<AShooterWeapon>& WeaponClass : PendingPrewarmWeapons)
+	{
+		if (const UClass* LoadedClass = WeaponClass.Get())
+		{
+			// the class default has no archetype of its own, so look up the one its instances will use
+			const AShooterWeapon* WeaponCDO = LoadedClass->GetDefaultObject<AShooterWeapon>();
+			WeaponCDO->GetSoftAssetPaths(DependencyPaths, WeaponCDO->FindArchetype(GetGameInstance()));
+		}
+	}
+
+	if (DependencyPaths.IsEmpty())
+	{
+		FinishPrewarm();
+		return;
+	}
+
+	PrewarmDependenciesHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(DependencyPaths, FStreamableDelegate::CreateUObject(this, &AHellWaveArenaGameMode::FinishPrewarm));
+}
+
+void AHellWaveArenaGameMode::FinishPrewarm()
+{
+	const double WarmStartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogHellWave, Log, TEXT("Prewarm: streamed %d weapon classes and their assets in %.2f ms."), PendingPrewarmWeapons.Num(), (WarmStartTime - PrewarmStartTime) * 1000.0);
+
+	// Park a hidden copy of each weapon on every player pawn
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		AShooterCharacter* PlayerCharacter = It->Get() ? Cast<AShooterCharacter>(It->Get()->GetPawn()) : nullptr;
+		if (!PlayerCharacter)
+		{
+			continue;
+		}
+
+		for (const TSoftClassPtr<AShooterWeapon>& WeaponClass : PendingPrewarmWeapons)
+		{
+			const double WeaponStartTime = FPlatformTime::Seconds();
+
+			PlayerCharacter->PrewarmWeaponClass(WeaponClass.Get());
+
+			UE_LOG(LogHellWave, Log, TEXT("Prewarm: weapon %s and its anim layers, %.2f ms."), *WeaponClass.GetAssetName(), (FPlatformTime::Seconds() - WeaponStartTime) * 1000.0);
+		}
+	}
+
+	// Assets and the HUD persist across restarts, so they only need warming once
+	if (!bPrewarmedSession)
+	{
+		bPrewarmedSession = true;
+
+		PrewarmSessionAssets();
+
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			if (AHellWaveArenaPlayerController* ArenaPC = Cast<AHellWaveArenaPlayerController>(It->Get()))
+			{
+				const double HUDStartTime = FPlatformTime::Seconds();
+				const int32 NumAnimations = ArenaPC->PrewarmHUD();
+
+				UE_LOG(LogHellWave, Log, TEXT("Prewarm: %d HUD animations, %.2f ms."), NumAnimations, (FPlatformTime::Seconds() - HUDStartTime) * 1000.0);
+			}
+		}
+	}
+
+	UE_LOG(LogHellWave, Log, TEXT("Prewarm: done in %.2f ms after streaming, inside a %.1f s start delay."), (FPlatformTime::Seconds() - WarmStartTime) * 1000.0, StartDelay);
+
+	LogResidentAssetMemory(TEXT("after prewarm"));
+}
+
+void AHellWaveArenaGameMode::PrewarmSessionAssets()
+{
+	for (const TSoftObjectPtr<UObject>& SoftAsset : PrewarmAssets)
+	{
+		const double AssetStartTime = FPlatformTime::Seconds();
+
+		UObject* Asset = SoftAsset.LoadSynchronous();
+		if (!Asset)
+		{
+			UE_LOG(LogHellWave, Warning, TEXT("Prewarm: could not load %s."), *SoftAsset.ToString());
+			continue;
+		}
+
+		PrewarmedAssets.Add(Asset);
+
+		// Effects pay for their system instance and shaders on first spawn, so spawn one out of sight
+		if (UNiagaraSystem* System = Cast<UNiagaraSystem>(Asset))
+		{
+			UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, System, PrewarmLocation, FRotator::ZeroRotator, FVector(1.0f), true, true, ENCPoolMethod::None, false);
+		}
+
+		// Sounds stream their first chunk on first play
+		else if (USoundBase* Sound = Cast<USoundBase>(Asset))
+		{
+			UGameplayStatics::PrimeSound(Sound);
+		}
+
+		UE_LOG(LogHellWave, Log, TEXT("Prewarm: asset %s, %.2f ms."), *Asset->GetName(), (FPlatformTime::Seconds() - AssetStartTime) * 1000.0);
+	}
+}
+
+void AHellWaveArenaGameMode::LogResidentAssetMemory(const TCHAR* Label) const
+{
+	struct FAssetBucket
+	{
+		const TCHAR* Name;
+		UClass* Class;
+	};
+
+	const FAssetBucket Buckets[] = {
+		{ TEXT("Static meshes"), UStaticMesh::StaticClass() },
+		{ TEXT("Skeletal meshes"), USkeletalMesh::StaticClass() },
+		{ TEXT("Animations"), UAnimSequenceBase::StaticClass() },
+		{ TEXT("Textures"), UTexture::StaticClass() },
+		{ TEXT("Sounds"), USoundBase::StaticClass() },
+		{ TEXT("Niagara systems"), UNiagaraSystem::StaticClass() },
+		{ TEXT("Blueprint classes"), UBlueprintGeneratedClass::StaticClass() }
+	};
+
+	SIZE_T TotalBytes = 0;
+	TArray<UObject*> Objects;
+
+	UE_LOG(LogHellWave, Log, TEXT("Resident assets at %s:"), Label);
+
+	for (const FAssetBucket& Bucket : Buckets)
+	{
+		Objects.Reset();
+		GetObjectsOfClass(Bucket.Class, Objects, true, RF_ClassDefaultObject);
+
+		SIZE_T BucketBytes = 0;
+		for (const UObject* Object : Objects)
+		{
+			BucketBytes += Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+
+		TotalBytes += BucketBytes;
+
+		UE_LOG(LogHellWave, Log, TEXT("  %-18s %6d  %8.2f MB"), Bucket.Name, Objects.Num(), BucketBytes / (1024.0 * 1024.0));
+	}
+
+	UE_LOG(LogHellWave, Log, TEXT("  %-18s         %8.2f MB"), TEXT("Total"), TotalBytes / (1024.0 * 1024.0));
+}
@@ -5,10 +5,13 @@
 #include "CoreMinimal.h"
 #include "ShooterGameMode.h"
 #include "HellWaveWaveManager.h"
+#include "HellWaveArenaBakeData.h"
+#include "Engine/StreamableManager.h"
 #include "HellWaveArenaGameMode.generated.h"
 
 class UHellWaveWaveManager;
 class UHellWaveHUD;
+class AShooterWeapon;
 
 /**
  *  Game Mode for the HellWave arena wave shooter
@@ -34,6 +37,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="HellWave", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float StartDelay = 2.0f;
 
+	/** Scoring used to pick spawn transforms from the baked arena data */
+	UPROPERTY(EditAnywhere, Category="HellWave|Spawning")
+	FHellWaveSpawnScoring SpawnScoring;
+
 	/** The wave manager instance */
 	UPROPERTY()
 	TObjectPtr<UHellWaveWaveManager> WaveManager;
@@ -49,6 +56,74 @@ protected:
 	/** Timer for start delay */
 	FTimerHandle StartDelayTimer;
 
+	/** Weapon classes to stream in and prewarm during the start delay, in addition to the ones granted by pickups in the level */
+	UPROPERTY(EditAnywhere, Category="HellWave|Prewarm")
+	TArray<TSoftClassPtr<AShooterWeapon>> PrewarmWeaponClasses;
+
+	/** Effects, sounds and other assets to load and warm during the start delay */
+	UPROPERTY(EditAnywhere, Category="HellWave|Prewarm")
+	TArray<TSoftObjectPtr<UObject>> PrewarmAssets;
+
+	/** Location out of sight where prewarm effects are spawned */
+	UPROPERTY(EditAnywhere, Category="HellWave|Prewarm")
+	FVector PrewarmLocation = FVector(0.0f, 0.0f, -100000.0f);
+
+	/** Loaded prewarm assets, kept resident for the session */
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> PrewarmedAssets;
+
+	/** Set once the session-wide assets and HUD have been warmed */
+	bool bPrewarmedSession = false;
+
+	/** Weapon classes being streamed in for the current prewarm */
+	TArray<TSoftClassPtr<AShooterWeapon>> PendingPrewarmWeapons;
+
+	/** Keeps the streamed weapon classes and prewarm assets resident */
+	TSharedPtr<FStreamableHandle> PrewarmClassesHandle;
+
+	/** Keeps the streamed weapon dependencies resident */
+	TSharedPtr<FStreamableHandle> PrewarmDependenciesHandle;
+
+	/** Time the current prewarm started */
+	double PrewarmStartTime = 0.0;
+
+	/** If true, garbage collection is held off during waves and forced between them */
+	UPROPERTY(EditAnywhere, Category="HellWave|GC")
+	bool bManageGarbageCollection = true;
+
+	/** How often the next garbage collection is pushed back while a wave is active */
+	UPROPERTY(EditAnywhere, Category="HellWave|GC", meta = (ClampMin = 0.1, ClampMax = 10, Units = "s"))
+	float CombatGCDeferInterval = 1.0f;
+
+	/** Longest a wave can hold off garbage collection before an incremental pass is allowed through */
+	UPROPERTY(EditAnywhere, Category="HellWave|GC", meta = (ClampMin = 5, ClampMax = 600, Units = "s"))
+	float MaxCombatGCDeferral = 90.0f;
+
+	/** Timer that keeps pushing back garbage collection during a wave */
+	FTimerHandle CombatGCTimer;
+
+	/** Time the current combat deferral started */
+	double CombatGCDeferStartTime = 0.0;
+
+	/** Wave number garbage collection stats are being gathered for */
+	int32 GCReportWave = 0;
+
+	/** Garbage collections during the reported wave */
+	int32 WaveGCCount = 0;
+
+	/** Total garbage collection time during the reported wave */
+	double WaveGCTime = 0.0;
+
+	/** Longest garbage collection during the reported wave */
+	double WaveGCMaxTime = 0.0;
+
+	/** Time the in-flight garbage collection started */
+	double GCStartTime = 0.0;
+
+	/** Garbage collection delegate handles */
+	FDelegateHandle PreGCHandle;
+	FDelegateHandle PostGCHandle;
+
 public:
 
 	AHellWaveArenaGameMode();
@@ -58,12 +133,58 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Creates a fresh wave manager and subscribes to it */
+	void CreateWaveManager();
+
+	/** Releases the current wave manager and cancels anything it has scheduled */
+	void ReleaseWaveManager();
+
 	/** Called after start delay to begin waves */
 	void OnStartDelayComplete();
 
+	/** Destroys enemies, their controllers and in-flight projectiles, and resets pickups */
+	void ClearArenaActors();
+
+	/** Replaces every player's pawn with a freshly spawned one */
+	void RestartArenaPlayers();
+
+	/** Streams in everything the arena needs, then pays first-use costs for weapons, anim layers, effects, sounds and HUD animations during the start delay */
+	void PrewarmArena();
+
+	/** Called when the weapon classes and prewarm assets are resident. Streams in the weapons' own soft references */
+	void OnPrewarmClassesLoaded();
+
+	/** Called when everything is resident. Parks weapons and warms assets and the HUD */
+	void FinishPrewarm();
+
+	/** Logs the count and estimated size of resident meshes, animations, textures, sounds, effects and Blueprint classes */
+	void LogResidentAssetMemory(const TCHAR* Label) const;
+
+	/** Loads the prewarm assets and spawns or primes them once out of sight */
+	void PrewarmSessionAssets();
+
 	/** Gather spawn points from the level by tag */
 	TArray<AActor*> GatherSpawnPoints() const;
 
+	/** Returns true if any enemy NPC is still alive */
+	bool HasLivingEnemies() const;
+
+	/** Starts holding off garbage collection for an active wave */
+	void BeginCombatGC(int32 WaveNumber);
+
+	/** Stops holding off garbage collection and forces a full purge */
+	void BeginIntermissionGC();
+
+	/** Pushes the next garbage collection back, or lets an incremental pass through if it's been held too long */
+	void DeferCombatGC();
+
+	/** Logs and resets the garbage collection stats for the reported wave */
+	void ReportWaveGC();
+
+	/** Garbage collection timing callbacks */
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
 public:
 
 	/** Called when the wave state changes */
@@ -75,4 +196,12 @@ public:
 
 	/** Notify that the player has died — triggers defeat */
 	void NotifyPlayerDeath();
+
+	/** Resets the arena in place and re-runs the start delay, without reloading the map */
+	UFUNCTION(BlueprintCallable, Category="HellWave")
+	void RestartArena();
+
+	/** Returns up to Count spawn transforms scored against the player from the baked arena data. Empty if the arena has no bake */
+	UFUNCTION(BlueprintCallable, Category="HellWave|Spawning")
+	TArray<FTransform> SelectSpawnTransforms(int32 Count) const;
 };
@@ -2,10 +2,44 @@
 
 #include "HellWaveArenaPlayerController.h"
 #include "HellWaveArenaCharacter.h"
+#include "HellWaveDashComponent.h"
 #include "HellWaveArenaGameMode.h"
 #include "HellWaveHUD.h"
+#include "ShooterBulletCounterUI.h"
+#include "Animation/WidgetAnimation.h"
 #include "Engine/World.h"
 
+namespace
+{
+	/** Plays and immediately stops every widget animation declared on the widget's class */
+	int32 PrewarmWidgetAnimations(UUserWidget* Widget)
+	{
+		if (!IsValid(Widget))
+		{
+			return 0;
+		}
+
+		int32 NumWarmed = 0;
+
+		for (TFieldIterator<FObjectProperty> It(Widget->GetClass()); It; ++It)
+		{
+			if (!It->PropertyClass->IsChildOf(UWidgetAnimation::StaticClass()))
+			{
+				continue;
+			}
+
+			if (UWidgetAnimation* Animation = Cast<UWidgetAnimation>(It->GetObjectPropertyValue_InContainer(Widget)))
+			{
+				Widget->PlayAnimation(Animation);
+				Widget->StopAnimation(Animation);
+				++NumWarmed;
+			}
+		}
+
+		return NumWarmed;
+	}
+}
+
 void AHellWaveArenaPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
@@ -29,6 +63,16 @@ void AHellWaveArenaPlayerController::OnPossess(APawn* InPawn)
 	if (AHellWaveArenaCharacter* ArenaChar = Cast<AHellWaveArenaCharacter>(InPawn))
 	{
 		BindCharacterDelegates(ArenaChar);
+
+		// Push the fresh character's resources so the HUD doesn't show the previous pawn's state
+		OnArmorUpdated(ArenaChar->GetCurrentArmor(), ArenaChar->GetMaxArmor());
+		OnChainsawFuelUpdated(ArenaChar->GetChainsawFuel());
+		OnFlameBelchCooldownUpdated(1.0f);
+
+		if (UHellWaveDashComponent* Dash = ArenaChar->GetDashComponent())
+		{
+			OnDashChargesUpdated(Dash->GetCurrentCharges(), Dash->GetMaxCharges());
+		}
 	}
 
 	// Override the destroy handler — no respawning in arena mode
@@ -83,3 +127,8 @@ void AHellWaveArenaPlayerController::OnFlameBelchCooldownUpdated(float CooldownP
 		HellWaveHUD->BP_UpdateFlameBelchCooldown(CooldownPercent);
 	}
 }
+
+int32 AHellWaveArenaPlayerController::PrewarmHUD()
+{
+	return PrewarmWidgetAnimations(HellWaveHUD) + PrewarmWidgetAnimations(BulletCounterUI);
+}
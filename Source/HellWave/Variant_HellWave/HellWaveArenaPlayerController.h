@@ -54,4 +54,9 @@ protected:
 
 	UFUNCTION()
 	void OnFlameBelchCooldownUpdated(float CooldownPercent);
+
+public:
+
+	/** Plays and stops every animation on the HUD widgets so their players exist before first use. Returns the number of animations warmed */
+	int32 PrewarmHUD();
 };
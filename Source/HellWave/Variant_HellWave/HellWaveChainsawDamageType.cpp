@@ -0,0 +1,13 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveChainsawDamageType.h"
+#include "HellWaveEnemy.h"
+
+void UHellWaveChainsawDamageType::ApplyFinisher(AActor* Target, AController* Instigator, AActor* Causer) const
+{
+	AHellWaveEnemy* Enemy = Cast<AHellWaveEnemy>(Target);
+	if (Enemy && !Enemy->IsEnemyDead())
+	{
+		Enemy->OnChainsawKilled();
+	}
+}
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HellWaveFinisherDamageType.h"
+#include "HellWaveChainsawDamageType.generated.h"
+
+/**
+ *  Chainsaw finisher. Runs the enemy's chainsaw death when the damage pass reaches it
+ */
+UCLASS(const)
+class HELLWAVE_API UHellWaveChainsawDamageType : public UHellWaveFinisherDamageType
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Chainsaws the target if it's a living enemy */
+	virtual void ApplyFinisher(AActor* Target, AController* Instigator, AActor* Causer) const override;
+};
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HellWaveFinisherDamageType.h"
+#include "HellWaveGloryKillDamageType.generated.h"
+
+/**
+ *  Glory kill finisher. Runs the enemy's glory kill death when the damage pass reaches it
+ */
+UCLASS(const)
+class HELLWAVE_API UHellWaveGloryKillDamageType : public UHellWaveFinisherDamageType
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Glory kills the target if it's a living enemy */
+	virtual void ApplyFinisher(AActor* Target, AController* Instigator, AActor* Causer) const override;
+};
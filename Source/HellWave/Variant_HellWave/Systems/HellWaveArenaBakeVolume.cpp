@@ -0,0 +1,539 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HellWaveArenaBakeVolume.h"
+#include "HellWaveArenaBakeData.h"
+#include "HellWaveArenaDataSubsystem.h"
+#include "HellWaveCollisionProfileSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "NavigationSystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HellWave.h"
+
+AHellWaveArenaBakeVolume::AHellWaveArenaBakeVolume()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// create the arena bounds box as the root
+	RootComponent = ArenaBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Arena Bounds"));
+
+	ArenaBounds->SetBoxExtent(FVector(2500.0f, 2500.0f, 500.0f));
+	ArenaBounds->SetCollisionProfileName(FName("NoCollision"));
+	ArenaBounds->SetGenerateOverlapEvents(false);
+}
+
+void AHellWaveArenaBakeVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// hand the baked data to the world
+	if (BakeData)
+	{
+		GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>()->SetBakeData(BakeData);
+	}
+}
+
+void AHellWaveArenaBakeVolume::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	if (UHellWaveArenaDataSubsystem* ArenaData = GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>())
+	{
+		ArenaData->ClearBakeData(BakeData);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FBox AHellWaveArenaBakeVolume::GetArenaBox() const
+{
+	const FVector Center = ArenaBounds->GetComponentLocation();
+	const FVector Extent = ArenaBounds->GetScaledBoxExtent();
+	return FBox(Center - Extent, Center + Extent);
+}
+
+#if WITH_EDITOR
+
+void AHellWaveArenaBakeVolume::BakeSpawnPoints()
+{
+	if (!BakeData)
+	{
+		UE_LOG(LogHellWave, Error, TEXT("%s: assign a bake data asset before baking."), *GetName());
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+
+	if (!NavSys)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("%s: no navigation system, spawn points will be baked as unreachable."), *GetName());
+	}
+
+	BakeZones();
+
+	// reachability is measured against the arena center
+	FVector ArenaCenter = GetArenaBox().GetCenter();
+	FNavLocation ArenaCenterNav;
+	const bool bCenterOnNav = NavSys && NavSys->ProjectPointToNavigation(ArenaCenter, ArenaCenterNav, GetArenaBox().GetExtent());
+
+	if (bCenterOnNav)
+	{
+		ArenaCenter = ArenaCenterNav.Location;
+	}
+
+	TArray<AActor*> SpawnPointActors = GatherTaggedActors(SpawnPointTag);
+
+	BakeData->SpawnPoints.Reset(SpawnPointActors.Num());
+	BakeData->SpawnSlotRadius = SpawnSlotRadius;
+
+	const FCollisionShape SlotCapsule = FCollisionShape::MakeCapsule(SlotCapsuleRadius, SlotCapsuleHalfHeight);
+
+	for (AActor* SpawnPointActor : SpawnPointActors)
+	{
+		FHellWaveBakedSpawnPoint& Point = BakeData->SpawnPoints.AddDefaulted_GetRef();
+		Point.Location = SpawnPointActor->GetActorLocation();
+		Point.Yaw = SpawnPointActor->GetActorRotation().Yaw;
+
+		// project onto the navmesh and check the path back to the arena
+		FNavLocation NavLocation;
+		if (NavSys && NavSys->ProjectPointToNavigation(Point.Location, NavLocation, NavProjectionExtent))
+		{
+			Point.Location = NavLocation.Location;
+
+			FVector::FReal PathLength = 0.0;
+			if (bCenterOnNav && NavSys->GetPathLength(Point.Location, ArenaCenter, PathLength) == ENavigationQueryResult::Success)
+			{
+				Point.PathLength = PathLength;
+			}
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HellWaveBakeSpawnPoints), false, SpawnPointActor);
+
+		// record which zones have line of sight to the spawn point
+		for (int32 ZoneIndex = 0; ZoneIndex < BakeData->Zones.Num(); ++ZoneIndex)
+		{
+			if (CanSeeBox(Point.Location, EyeHeight, BakeData->Zones[ZoneIndex].Bounds, QueryParams))
+			{
+				Point.VisibleZoneMask |= (1u << ZoneIndex);
+			}
+		}
+
+		// record which ring slots have navmesh and room for a capsule
+		for (int32 SlotIndex = 0; SlotIndex < UHellWaveArenaBakeData::NumSpawnSlots; ++SlotIndex)
+		{
+			const FVector SlotLocation = Point.Location + BakeData->GetSpawnSlotOffset(SlotIndex);
+
+			FNavLocation SlotNav;
+			if (NavSys && !NavSys->ProjectPointToNavigation(SlotLocation, SlotNav, FVector(SlotCapsuleRadius, SlotCapsuleRadius, SlotCapsuleHalfHeight)))
+			{
+				continue;
+			}
+
+			const FVector CapsuleCenter = SlotLocation + FVector(0.0f, 0.0f, SlotCapsuleHalfHeight + 5.0f);
+			if (!World->OverlapBlockingTestByChannel(CapsuleCenter, FQuat::Identity, ECC_Pawn, SlotCapsule, QueryParams))
+			{
+				Point.FreeSlotMask |= (1 << SlotIndex);
+			}
+		}
+	}
+
+	BakeData->MarkPackageDirty();
+
+	UE_LOG(LogHellWave, Log, TEXT("%s: baked %d zones and %d spawn points into %s."), *GetName(), BakeData->Zones.Num(), BakeData->SpawnPoints.Num(), *BakeData->GetName());
+}
+
+void AHellWaveArenaBakeVolume::BakeVisibility()
+{
+	if (!BakeData)
+	{
+		UE_LOG(LogHellWave, Error, TEXT("%s: assign a bake data asset before baking."), *GetName());
+		return;
+	}
+
+	const FBox ArenaBox = GetArenaBox();
+
+	// grow the cell size until the grid fits in the matrix budget
+	float CellSize = VisibilityCellSize;
+	FIntVector Dims;
+
+	for (;;)
+	{
+		const FVector Size = ArenaBox.GetSize() / CellSize;
+		Dims = FIntVector(FMath::Max(1, FMath::CeilToInt32(Size.X)), FMath::Max(1, FMath::CeilToInt32(Size.Y)), FMath::Max(1, FMath::CeilToInt32(Size.Z)));
+
+		if (int64(Dims.X) * Dims.Y * Dims.Z <= UHellWaveArenaBakeData::MaxVisibilityCells)
+		{
+			break;
+		}
+
+		CellSize *= 1.25f;
+	}
+
+	if (CellSize != VisibilityCellSize)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("%s: visibility cell size raised from %.0f to %.0f to stay within %d cells."), *GetName(), VisibilityCellSize, CellSize, UHellWaveArenaBakeData::MaxVisibilityCells);
+	}
+
+	BakeData->VisibilityBounds = FBox(ArenaBox.Min, ArenaBox.Min + FVector(Dims) * CellSize);
+	BakeData->VisibilityCellSize = CellSize;
+	BakeData->VisibilityDims = Dims;
+
+	const int32 NumCells = BakeData->GetNumVisibilityCells();
+	const int64 NumBits = int64(NumCells) * NumCells;
+
+	// every pair starts potentially visible. The bake only clears the pairs it can prove are occluded,
+	// so a pair it runs out of time on, or can't decide, still gets a real trace at runtime
+	BakeData->VisibilityBits.Reset();
+	BakeData->VisibilityBits.Init(~uint64(0), int32((NumBits + 63) / 64));
+
+	auto ClearBit = [this, NumCells](int32 A, int32 B)
+	{
+		const int64 Bit = int64(A) * NumCells + B;
+		BakeData->VisibilityBits[Bit >> 6] &= ~(uint64(1) << (Bit & 63));
+	};
+
+	const FVector CellExtent(CellSize * 0.5f);
+	TArray<FBox> CellBoxes;
+	CellBoxes.Reserve(NumCells);
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		const FVector Center = BakeData->GetVisibilityCellCenter(CellIndex);
+		CellBoxes.Add(FBox(Center - CellExtent, Center + CellExtent));
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HellWaveBakeVisibility), false, this);
+
+	// visibility is symmetric, so only test each pair once
+	const double BakeStartTime = FPlatformTime::Seconds();
+	const int64 NumPairs = int64(NumCells) * (NumCells - 1) / 2;
+	int64 TestedPairs = 0;
+	int64 OccludedPairs = 0;
+	bool bOutOfTime = false;
+
+	for (int32 CellA = 0; CellA < NumCells && !bOutOfTime; ++CellA)
+	{
+		for (int32 CellB = CellA + 1; CellB < NumCells; ++CellB)
+		{
+			if (AreCellsOccluded(CellBoxes[CellA], CellBoxes[CellB], QueryParams))
+			{
+				ClearBit(CellA, CellB);
+				ClearBit(CellB, CellA);
+				++OccludedPairs;
+			}
+		}
+
+		TestedPairs += NumCells - 1 - CellA;
+
+		if (FPlatformTime::Seconds() - BakeStartTime > VisibilityBakeTimeBudget)
+		{
+			bOutOfTime = true;
+		}
+	}
+
+	if (bOutOfTime)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("%s: visibility bake ran out of its %.0f s budget after %lld of %lld cell pairs. The rest are left potentially visible. Raise the cell size or the budget."),
+			*GetName(), VisibilityBakeTimeBudget, TestedPairs, NumPairs);
+	}
+
+	BakeData->MarkPackageDirty();
+
+	UE_LOG(LogHellWave, Log, TEXT("%s: baked %dx%dx%d visibility cells in %.1f s, %lld of %lld cell pairs proven occluded (%.1f%%), %d KB."),
+		*GetName(), Dims.X, Dims.Y, Dims.Z, FPlatformTime::Seconds() - BakeStartTime, OccludedPairs, NumPairs, NumPairs > 0 ? 100.0 * OccludedPairs / NumPairs : 0.0, BakeData->VisibilityBits.Num() * int32(sizeof(uint64)) / 1024);
+}
+
+void AHellWaveArenaBakeVolume::BakeTacticalGraph()
+{
+	if (!BakeData)
+	{
+		UE_LOG(LogHellWave, Error, TEXT("%s: assign a bake data asset before baking."), *GetName());
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+
+	if (!NavSys)
+	{
+		UE_LOG(LogHellWave, Error, TEXT("%s: tactical graph bake requires a navigation system."), *GetName());
+		return;
+	}
+
+	BakeZones();
+
+	const FBox ArenaBox = GetArenaBox();
+	const FVector ArenaCenter = ArenaBox.GetCenter();
+	const int32 NumZones = BakeData->Zones.Num();
+
+	// gather candidate locations from a grid over the arena plus any hand-placed points
+	TArray<FVector> Candidates;
+
+	for (float X = ArenaBox.Min.X + TacticalNodeSpacing * 0.5f; X < ArenaBox.Max.X; X += TacticalNodeSpacing)
+	{
+		for (float Y = ArenaBox.Min.Y + TacticalNodeSpacing * 0.5f; Y < ArenaBox.Max.Y; Y += TacticalNodeSpacing)
+		{
+			Candidates.Emplace(X, Y, ArenaCenter.Z);
+		}
+	}
+
+	for (AActor* TacticalPoint : GatherTaggedActors(TacticalPointTag))
+	{
+		Candidates.Add(TacticalPoint->GetActorLocation());
+	}
+
+	// project the candidates onto the navmesh, dropping duplicates and misses
+	const FVector GridProjectionExtent(TacticalNodeSpacing * 0.5f, TacticalNodeSpacing * 0.5f, ArenaBox.GetExtent().Z);
+	const float MinNodeDistSquared = FMath::Square(TacticalNodeSpacing * 0.25f);
+
+	BakeData->TacticalNodes.Reset();
+
+	for (const FVector& Candidate : Candidates)
+	{
+		FNavLocation NavLocation;
+		if (!NavSys->ProjectPointToNavigation(Candidate, NavLocation, GridProjectionExtent) || !ArenaBox.IsInsideOrOn(NavLocation.Location))
+		{
+			continue;
+		}
+
+		const bool bDuplicate = BakeData->TacticalNodes.ContainsByPredicate([&](const FHellWaveTacticalNode& Node)
+		{
+			return FVector::DistSquared(Node.Location, NavLocation.Location) < MinNodeDistSquared;
+		});
+
+		if (!bDuplicate)
+		{
+			BakeData->TacticalNodes.AddDefaulted_GetRef().Location = NavLocation.Location;
+		}
+	}
+
+	// project the zone centers so we can measure nav distances to them
+	TArray<FVector> ZoneNavCenters;
+	TArray<bool> ZoneOnNav;
+	ZoneNavCenters.SetNum(NumZones);
+	ZoneOnNav.SetNum(NumZones);
+
+	for (int32 ZoneIndex = 0; ZoneIndex < NumZones; ++ZoneIndex)
+	{
+		const FBox& Bounds = BakeData->Zones[ZoneIndex].Bounds;
+
+		FNavLocation ZoneNav;
+		ZoneOnNav[ZoneIndex] = NavSys->ProjectPointToNavigation(Bounds.GetCenter(), ZoneNav, Bounds.GetExtent());
+		ZoneNavCenters[ZoneIndex] = ZoneOnNav[ZoneIndex] ? ZoneNav.Location : Bounds.GetCenter();
+	}
+
+	BakeData->TacticalZoneDistances.Init(-1.0f, BakeData->TacticalNodes.Num() * NumZones);
+
+	const float FlankDot = FMath::Cos(FMath::DegreesToRadians(FlankAngle));
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HellWaveBakeTacticalGraph), false, this);
+
+	int32 NumCover = 0, NumFlank = 0, NumHighGround = 0;
+
+	for (int32 NodeIndex = 0; NodeIndex < BakeData->TacticalNodes.Num(); ++NodeIndex)
+	{
+		FHellWaveTacticalNode& Node = BakeData->TacticalNodes[NodeIndex];
+
+		for (int32 ZoneIndex = 0; ZoneIndex < NumZones; ++ZoneIndex)
+		{
+			const FBox& Bounds = BakeData->Zones[ZoneIndex].Bounds;
+			const uint32 ZoneBit = 1u << ZoneIndex;
+
+			// nav distance from the node to the zone
+			FVector::FReal PathLength = 0.0;
+			if (ZoneOnNav[ZoneIndex] && NavSys->GetPathLength(Node.Location, ZoneNavCenters[ZoneIndex], PathLength) == ENavigationQueryResult::Success)
+			{
+				BakeData->TacticalZoneDistances[NodeIndex * NumZones + ZoneIndex] = PathLength;
+			}
+
+			if (!CanSeeBox(Node.Location, EyeHeight, Bounds, QueryParams))
+			{
+				continue;
+			}
+
+			Node.VisibleZoneMask |= ZoneBit;
+
+			// cover means we can shoot at the zone standing and hide from it crouched
+			if (!CanSeeBox(Node.Location, CrouchHeight, Bounds, QueryParams))
+			{
+				Node.CoverZoneMask |= ZoneBit;
+			}
+
+			// flanking means the node is off the line between the zone and the arena center
+			const FVector ZoneToNode = (Node.Location - Bounds.GetCenter()).GetSafeNormal2D();
+			const FVector ZoneToCenter = (ArenaCenter - Bounds.GetCenter()).GetSafeNormal2D();
+
+			if (!ZoneToCenter.IsNearlyZero() && FVector::DotProduct(ZoneToNode, ZoneToCenter) < FlankDot)
+			{
+				Node.FlankZoneMask |= ZoneBit;
+			}
+
+			if (Node.Location.Z - Bounds.Min.Z >= HighGroundHeight)
+			{
+				Node.HighGroundZoneMask |= ZoneBit;
+			}
+		}
+
+		Node.Flags = 0;
+		Node.Flags |= Node.CoverZoneMask ? uint8(EHellWaveTacticalFlags::Cover) : 0;
+		Node.Flags |= Node.FlankZoneMask ? uint8(EHellWaveTacticalFlags::Flank) : 0;
+		Node.Flags |= Node.HighGroundZoneMask ? uint8(EHellWaveTacticalFlags::HighGround) : 0;
+
+		NumCover += Node.CoverZoneMask ? 1 : 0;
+		NumFlank += Node.FlankZoneMask ? 1 : 0;
+		NumHighGround += Node.HighGroundZoneMask ? 1 : 0;
+	}
+
+	BakeData->MarkPackageDirty();
+
+	UE_LOG(LogHellWave, Log, TEXT("%s: baked %d tactical nodes over %d zones (%d cover, %d flank, %d high ground)."),
+		*GetName(), BakeData->TacticalNodes.Num(), NumZones, NumCover, NumFlank, NumHighGround);
+}
+
+TArray<AActor*> AHellWaveArenaBakeVolume::GatherTaggedActors(FName Tag) const
+{
+	TArray<AActor*> Found;
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (It->Tags.Contains(Tag))
+		{
+			Found.Add(*It);
+		}
+	}
+
+	Found.Sort([](const AActor& A, const AActor& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+
+	return Found;
+}
+
+void AHellWaveArenaBakeVolume::BakeZones()
+{
+	TArray<AActor*> ZoneActors = GatherTaggedActors(ArenaZoneTag);
+
+	if (ZoneActors.Num() > UHellWaveArenaBakeData::MaxZones)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("%s: %d zones found, only the first %d will be baked."), *GetName(), ZoneActors.Num(), UHellWaveArenaBakeData::MaxZones);
+		ZoneActors.SetNum(UHellWaveArenaBakeData::MaxZones);
+	}
+
+	BakeData->Zones.Reset(ZoneActors.Num());
+
+	for (AActor* ZoneActor : ZoneActors)
+	{
+		FHellWaveArenaZone& Zone = BakeData->Zones.AddDefaulted_GetRef();
+		Zone.ZoneName = ZoneActor->GetFName();
+		Zone.Bounds = ZoneActor->GetComponentsBoundingBox(true);
+	}
+}
+
+bool AHellWaveArenaBakeVolume::CanSeeBox(const FVector& Location, float Height, const FBox& Box, const FCollisionQueryParams& QueryParams) const
+{
+	const FVector Eye = Location + FVector(0.0f, 0.0f, Height);
+	const FVector Center = Box.GetCenter();
+	const FVector Extent = Box.GetExtent() * 0.8f;
+
+	// center plus four points on the zone's horizontal midplane, at eye height
+	const FVector Samples[] = {
+		Center,
+		Center + FVector( Extent.X,  Extent.Y, 0.0f),
+		Center + FVector(-Extent.X,  Extent.Y, 0.0f),
+		Center + FVector( Extent.X, -Extent.Y, 0.0f),
+		Center + FVector(-Extent.X, -Extent.Y, 0.0f)
+	};
+
+	for (const FVector& Sample : Samples)
+	{
+		const FVector Target(Sample.X, Sample.Y, Box.Min.Z + EyeHeight);
+
+		if (!GetWorld()->LineTraceTestByChannel(Eye, Target, ECC_HellWaveAISight, QueryParams))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AHellWaveArenaBakeVolume::AreCellsOccluded(const FBox& CellA, const FBox& CellB, const FCollisionQueryParams& QueryParams) const
+{
+	const FVector CenterA = CellA.GetCenter();
+	const FVector CenterB = CellB.GetCenter();
+
+	// a clear line between the centers means the cells see each other
+	FHitResult Hit;
+	if (!GetWorld()->LineTraceSingleByChannel(Hit, CenterA, CenterB, ECC_HellWaveAISight, QueryParams))
+	{
+		return false;
+	}
+
+	// the first blocker from either side is a candidate for separating the cells
+	UPrimitiveComponent* Candidate = Hit.GetComponent();
+	if (IsConvexOccluder(Candidate) && DoesOccluderSeparate(Candidate, CellA, CellB))
+	{
+		return true;
+	}
+
+	if (GetWorld()->LineTraceSingleByChannel(Hit, CenterB, CenterA, ECC_HellWaveAISight, QueryParams) && Hit.GetComponent() != Candidate)
+	{
+		return IsConvexOccluder(Hit.GetComponent()) && DoesOccluderSeparate(Hit.GetComponent(), CellA, CellB);
+	}
+
+	return false;
+}
+
+bool AHellWaveArenaBakeVolume::IsConvexOccluder(UPrimitiveComponent* Component)
+{
+	// the occluder can't move after the bake, and has to stop every trace the grid culls
+	if (!Component || Component->Mobility == EComponentMobility::Movable)
+	{
+		return false;
+	}
+
+	// judge the collision the component will have at runtime, not the one it has in the editor
+	FCollisionResponseContainer Responses = Component->GetCollisionResponseToChannels();
+	const FName RuntimeProfile = UHellWaveCollisionProfileSubsystem::FindProfileOverride(Component);
+
+	FCollisionResponseTemplate ProfileTemplate;
+	if (!RuntimeProfile.IsNone() && UCollisionProfile::Get()->GetProfileTemplate(RuntimeProfile, ProfileTemplate))
+	{
+		Responses = ProfileTemplate.ResponseToChannels;
+	}
+
+	if (Responses.GetResponse(ECC_HellWaveAISight) != ECR_Block || Responses.GetResponse(ECC_HellWaveHitscan) != ECR_Block)
+	{
+		return false;
+	}
+
+	// runtime sight traces use simple collision, so the occluder must be exactly one convex element
+	const UBodySetup* BodySetup = Component->GetBodySetup();
+	return BodySetup && BodySetup->GetCollisionTraceFlag() != CTF_UseComplexAsSimple && BodySetup->AggGeom.GetElementCount() == 1;
+}
+
+bool AHellWaveArenaBakeVolume::DoesOccluderSeparate(UPrimitiveComponent* Occluder, const FBox& CellA, const FBox& CellB)
+{
+	// if a convex occluder cuts every line between the corners of two boxes, it cuts every line between any two points in them.
+	// the lines from a fixed point that hit a convex shape end in a convex set, so covering the corners covers the whole box
+	FVector CornersA[8];
+	FVector CornersB[8];
+	CellA.GetVertices(CornersA);
+	CellB.GetVertices(CornersB);
+
+	const FCollisionQueryParams ComponentParams(SCENE_QUERY_STAT(HellWaveBakeOccluder), false);
+	FHitResult Hit;
+
+	for (const FVector& CornerA : CornersA)
+	{
+		for (const FVector& CornerB : CornersB)
+		{
+			if (!Occluder->LineTraceComponent(Hit, CornerA, CornerB, ComponentParams))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_EDITOR
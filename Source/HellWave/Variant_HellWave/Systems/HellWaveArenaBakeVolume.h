@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HellWaveArenaBakeVolume.generated.h"
+
+class UBoxComponent;
+class UPrimitiveComponent;
+class UHellWaveArenaBakeData;
+
+/**
+ *  Marks the playable arena volume and bakes static arena data in the editor
+ *  Place one per arena level and assign a bake data asset
+ *  At runtime it hands the baked data to UHellWaveArenaDataSubsystem
+ */
+UCLASS()
+class HELLWAVE_API AHellWaveArenaBakeVolume : public AActor
+{
+	GENERATED_BODY()
+
+	/** Bounds of the playable arena */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UBoxComponent* ArenaBounds;
+
+protected:
+
+	/** Asset that receives the baked data */
+	UPROPERTY(EditAnywhere, Category="Bake")
+	TObjectPtr<UHellWaveArenaBakeData> BakeData;
+
+	/** Tag used to find spawn point actors in the level */
+	UPROPERTY(EditAnywhere, Category="Bake|Spawn Points")
+	FName SpawnPointTag = FName("EnemySpawnPoint");
+
+	/** Tag used to find arena zone actors. Zone extents come from the actor bounds */
+	UPROPERTY(EditAnywhere, Category="Bake|Zones")
+	FName ArenaZoneTag = FName("ArenaZone");
+
+	/** Query extent used to project points onto the navmesh */
+	UPROPERTY(EditAnywhere, Category="Bake|Navigation")
+	FVector NavProjectionExtent = FVector(100.0f, 100.0f, 250.0f);
+
+	/** Height above the ground used for visibility traces */
+	UPROPERTY(EditAnywhere, Category="Bake|Visibility", meta = (ClampMin = 0, ClampMax = 300, Units = "cm"))
+	float EyeHeight = 150.0f;
+
+	/** Distance from a spawn point to its ring slots */
+	UPROPERTY(EditAnywhere, Category="Bake|Spawn Points", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float SpawnSlotRadius = 120.0f;
+
+	/** Capsule radius tested for free spawn slots */
+	UPROPERTY(EditAnywhere, Category="Bake|Spawn Points", meta = (ClampMin = 0, ClampMax = 200, Units = "cm"))
+	float SlotCapsuleRadius = 35.0f;
+
+	/** Capsule half height tested for free spawn slots */
+	UPROPERTY(EditAnywhere, Category="Bake|Spawn Points", meta = (ClampMin = 0, ClampMax = 200, Units = "cm"))
+	float SlotCapsuleHalfHeight = 90.0f;
+
+	/** Edge length of a visibility grid cell. Larger cells give a smaller, more conservative matrix */
+	UPROPERTY(EditAnywhere, Category="Bake|Visibility", meta = (ClampMin = 50, ClampMax = 2000, Units = "cm"))
+	float VisibilityCellSize = 400.0f;
+
+	/** Max time the visibility bake may run. Cell pairs not reached in time are left potentially visible */
+	UPROPERTY(EditAnywhere, Category="Bake|Visibility", meta = (ClampMin = 1, ClampMax = 3600, Units = "s"))
+	float VisibilityBakeTimeBudget = 120.0f;
+
+	/** Spacing of the navmesh sample grid used to generate tactical nodes */
+	UPROPERTY(EditAnywhere, Category="Bake|Tactical", meta = (ClampMin = 50, ClampMax = 2000, Units = "cm"))
+	float TacticalNodeSpacing = 300.0f;
+
+	/** Tag used to find hand-placed tactical point actors, baked in addition to the generated grid */
+	UPROPERTY(EditAnywhere, Category="Bake|Tactical")
+	FName TacticalPointTag = FName("TacticalPoint");
+
+	/** Height above the ground used for crouched visibility traces */
+	UPROPERTY(EditAnywhere, Category="Bake|Tactical", meta = (ClampMin = 0, ClampMax = 300, Units = "cm"))
+	float CrouchHeight = 70.0f;
+
+	/** Min height above a zone's floor for a node to count as high ground over it */
+	UPROPERTY(EditAnywhere, Category="Bake|Tactical", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float HighGroundHeight = 150.0f;
+
+	/** Min angle between a node and the arena center, seen from a zone, for the node to flank that zone */
+	UPROPERTY(EditAnywhere, Category="Bake|Tactical", meta = (ClampMin = 0, ClampMax = 180, Units = "Degrees"))
+	float FlankAngle = 60.0f;
+
+public:
+
+	/** Constructor */
+	AHellWaveArenaBakeVolume();
+
+protected:
+
+	/** Registers the baked data with the world */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the baked data */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+#if WITH_EDITOR
+	/** Bakes arena zones and spawn point metadata into the data asset */
+	UFUNCTION(CallInEditor, Category="Bake")
+	void BakeSpawnPoints();
+
+	/** Bakes the cell-to-cell visibility grid over the arena bounds into the data asset */
+	UFUNCTION(CallInEditor, Category="Bake")
+	void BakeVisibility();
+
+	/** Bakes the tactical node graph into the data asset. Rebakes zones, so spawn points should be rebaked if zones changed */
+	UFUNCTION(CallInEditor, Category="Bake")
+	void BakeTacticalGraph();
+#endif // WITH_EDITOR
+
+	/** Returns the arena bounds in world space */
+	FBox GetArenaBox() const;
+
+protected:
+
+#if WITH_EDITOR
+	/** Returns every actor in the level carrying the tag, sorted by name for stable bake order */
+	TArray<AActor*> GatherTaggedActors(FName Tag) const;
+
+	/** Bakes the zone list from the zone actors */
+	void BakeZones();
+
+	/** Returns true if a point at the given height above the location can see any sample in the box at eye height */
+	bool CanSeeBox(const FVector& Location, float Height, const FBox& Box, const FCollisionQueryParams& QueryParams) const;
+
+	/** Returns true if the bake can prove no point in cell A sees any point in cell B */
+	bool AreCellsOccluded(const FBox& CellA, const FBox& CellB, const FCollisionQueryParams& QueryParams) const;
+
+	/** Returns true if the component is a static, single convex shape that blocks both sight and hitscan traces */
+	static bool IsConvexOccluder(UPrimitiveComponent* Component);
+
+	/** Returns true if every line between the two boxes passes through the occluder */
+	static bool DoesOccluderSeparate(UPrimitiveComponent* Occluder, const FBox& CellA, const FBox& CellB);
+#endif // WITH_EDITOR
+};
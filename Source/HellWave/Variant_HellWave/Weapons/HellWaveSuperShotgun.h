@@ -9,6 +9,7 @@
 /**
  *  Super Shotgun weapon — hitscan shotgun that fires multiple pellet traces in a cone
  *  Each trigger pull fires all pellets simultaneously
+ *  Pellet count and spread come from the weapon archetype, which selects the spread fire pipeline
  *  Alt-fire launches the Meat Hook (Phase 2)
  */
 UCLASS(abstract)
@@ -18,13 +19,15 @@ class HELLWAVE_API AHellWaveSuperShotgun : public AHellWaveWeapon
 
 protected:
 
-	/** Number of pellets (line traces) fired per shot */
-	UPROPERTY(EditAnywhere, Category="Shotgun", meta = (ClampMin = 1, ClampMax = 20))
+#if WITH_EDITORONLY_DATA
+	/** Number of pellets (line traces) fired per shot. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Shotgun", meta = (ClampMin = 1, ClampMax = 20))
 	int32 PelletCount = 8;
 
-	/** Half-angle of the pellet spread cone in degrees */
-	UPROPERTY(EditAnywhere, Category="Shotgun", meta = (ClampMin = 0, ClampMax = 45, Units = "Degrees"))
+	/** Half-angle of the pellet spread cone in degrees. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Shotgun", meta = (ClampMin = 0, ClampMax = 45, Units = "Degrees"))
 	float SpreadHalfAngle = 8.0f;
+#endif // WITH_EDITORONLY_DATA
 
 public:
 
@@ -32,6 +35,8 @@ public:
 
 protected:
 
-	/** Override to fire multiple hitscan pellets in a spread pattern */
-	virtual void FireHitscan(const FVector& TargetLocation) override;
+#if WITH_EDITOR
+	/** Adds the pellet count and spread to the fallback tuning */
+	virtual void GetFallbackTuning(FWeaponTableRow& OutRow) const override;
+#endif // WITH_EDITOR
 };
@@ -2,101 +2,319 @@
 
 #include "HellWaveWeapon.h"
 #include "ShooterProjectile.h"
+#include "ShooterPickup.h"
 #include "ShooterWeaponHolder.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/Pawn.h"
-#include "Kismet/GameplayStatics.h"
 #include "Sound/SoundBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HellWaveHitboxSubsystem.h"
+#include "HellWaveImpulseSubsystem.h"
+#include "HellWaveImpactEffectsSubsystem.h"
+#include "HellWaveAudioEventSubsystem.h"
+#include "HellWaveDamageSubsystem.h"
+#include "HellWave.h"
 
-AHellWaveWeapon::AHellWaveWeapon()
+DECLARE_CYCLE_STAT(TEXT("Weapon Fire"), STAT_HellWaveWeaponFire, STATGROUP_HellWave);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Shots"), STAT_HellWaveWeaponShots, STATGROUP_HellWave);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Pellet"), STAT_HellWaveHitscanPellet, STATGROUP_HellWave);
+
+// Trace modes
+
+struct AHellWaveWeapon::FHitscanTrace
 {
-}
+	static FORCEINLINE void Shoot(AHellWaveWeapon& Weapon, const FVector& MuzzleLoc, const FVector& Direction, float TargetDistance)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HellWaveHitscanPellet);
 
-void AHellWaveWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
+		const FShooterWeaponArchetype& Tuning = *Weapon.Archetype;
+		const FVector TraceStart = MuzzleLoc + (Direction * Tuning.MuzzleOffset);
+		const FVector TraceEnd = TraceStart + (Direction * Tuning.HitscanRange);
+
+		// Meshes that publish hitboxes ignore the hitscan channel, so this only finds world geometry and pawns without hitboxes
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HellWaveHitscan));
+		QueryParams.AddIgnoredActor(Weapon.GetOwner());
+		QueryParams.bReturnPhysicalMaterial = true;
+
+		FHitResult HitResult;
+		Weapon.GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_HellWaveHitscan, QueryParams);
+
+		// Test the hitboxes in front of whatever the trace hit
+		FHellWaveHitboxHit HitboxHit;
+		if (Weapon.HitboxSubsystem && Weapon.HitboxSubsystem->TraceHitboxes(TraceStart, HitResult.bBlockingHit ? HitResult.ImpactPoint : TraceEnd, Weapon.GetOwner(), HitboxHit))
+		{
+			FHitResult HitboxResult(HitboxHit.Actor, HitboxHit.Component, HitboxHit.Location, HitboxHit.Normal);
+			HitboxResult.bBlockingHit = true;
+			HitboxResult.TraceStart = TraceStart;
+			HitboxResult.TraceEnd = TraceEnd;
+			HitboxResult.Distance = HitboxHit.Distance;
+			HitboxResult.BoneName = HitboxHit.BoneName;
+
+			Weapon.ProcessHitscan(HitboxResult, Direction, HitboxHit.DamageMultiplier);
+		}
+		else if (HitResult.bBlockingHit)
+		{
+			Weapon.ProcessHitscan(HitResult, Direction);
+		}
+	}
+};
+
+struct AHellWaveWeapon::FProjectileTrace
 {
-	Super::EndPlay(EndPlayReason);
-	GetWorld()->GetTimerManager().ClearTimer(ReloadTimer);
-}
+	static FORCEINLINE void Shoot(AHellWaveWeapon& Weapon, const FVector& MuzzleLoc, const FVector& Direction, float TargetDistance)
+	{
+		// Aim at the point the pellet direction reaches at the target's distance
+		Weapon.SpawnProjectile(Weapon.CalculateProjectileSpawnTransform(MuzzleLoc, MuzzleLoc + (Direction * TargetDistance)));
+	}
+};
 
-void AHellWaveWeapon::Fire()
+// Pellet patterns
+
+struct AHellWaveWeapon::FSinglePellet
 {
-	if (!bIsFiring || bIsReloading)
+	template<typename TShootFunc>
+	static FORCEINLINE void ForEachPellet(AHellWaveWeapon& Weapon, const FVector& AimDir, TShootFunc&& Shoot)
 	{
-		return;
+		Shoot(AimDir);
 	}
+};
 
-	// Check if we have ammo in the magazine
-	if (CurrentBullets <= 0)
+struct AHellWaveWeapon::FPelletSpread
+{
+	template<typename TShootFunc>
+	static FORCEINLINE void ForEachPellet(AHellWaveWeapon& Weapon, const FVector& AimDir, TShootFunc&& Shoot)
 	{
-		// Try to reload from reserve
-		if (ReserveAmmo > 0 && bAutoReloadFromReserve)
+		const FShooterWeaponArchetype& Tuning = *Weapon.Archetype;
+
+		// Next precomputed layout, rotated into the aim frame by a single quaternion
+		const int32 Variant = Weapon.SpreadShotIndex++ % Tuning.SpreadVariants;
+		const FVector* Layout = Tuning.SpreadDirections.GetData() + (Variant * Tuning.PelletCount);
+		const FQuat AimRotation = AimDir.ToOrientationQuat();
+
+		for (int32 PelletIndex = 0; PelletIndex < Tuning.PelletCount; ++PelletIndex)
 		{
-			ReloadFromReserve();
+			Shoot(AimRotation.RotateVector(Layout[PelletIndex]));
 		}
-		else if (DryFireSound)
+	}
+};
+
+// Ammo models
+
+template<bool bAutoReload, bool bReloadWhenEmptied>
+struct AHellWaveWeapon::TReserveAmmo
+{
+	/** Called instead of firing when the magazine is empty */
+	static FORCEINLINE void OnMagazineEmpty(AHellWaveWeapon& Weapon)
+	{
+		if (bAutoReload && Weapon.ReserveAmmo > 0)
+		{
+			Weapon.ReloadFromReserve();
+		}
+		else if (Weapon.DryFireSound)
 		{
 			// Completely out of ammo — play dry fire click to push player toward chainsaw
-			UGameplayStatics::PlaySoundAtLocation(this, DryFireSound, GetActorLocation());
+			if (UHellWaveAudioEventSubsystem* AudioEvents = Weapon.GetWorld()->GetSubsystem<UHellWaveAudioEventSubsystem>())
+			{
+				AudioEvents->PostSoundEvent(Weapon.DryFireSound, nullptr, Weapon.GetActorLocation());
+			}
 		}
-		return;
 	}
 
-	if (bShouldFireHitscan)
+	/** Called after a shot consumed a round */
+	static FORCEINLINE void OnShotFired(AHellWaveWeapon& Weapon)
 	{
-		FireHitscan(WeaponOwner->GetWeaponTargetLocation());
-	} else
-	{
-		// Fire a projectile at the target
-		FireProjectile(WeaponOwner->GetWeaponTargetLocation());
+		// Full auto weapons reload on the next trigger pull instead
+		if (bReloadWhenEmptied && Weapon.CurrentBullets <= 0 && Weapon.ReserveAmmo > 0)
+		{
+			Weapon.ReloadFromReserve();
+		}
 	}
+};
 
-	// Update the time of our last shot
-	TimeOfLastShot = GetWorld()->GetTimeSeconds();
-
-	// Make noise for AI perception
-	MakeNoise(ShotLoudness, PawnOwner, PawnOwner->GetActorLocation(), ShotNoiseRange, ShotNoiseTag);
+// Refire models
 
-	// Handle refire scheduling
-	if (bFullAuto)
+struct AHellWaveWeapon::FFullAutoRefire
+{
+	static FORCEINLINE void Schedule(AHellWaveWeapon& Weapon)
 	{
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AHellWaveWeapon::Fire, RefireRate, false);
+		// Shots come due through the base class tick, so there's no timer to set
 	}
-	else
+};
+
+struct AHellWaveWeapon::FSemiAutoRefire
+{
+	static FORCEINLINE void Schedule(AHellWaveWeapon& Weapon)
 	{
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AHellWaveWeapon::FireCooldownExpired, RefireRate, false);
+		Weapon.GetWorld()->GetTimerManager().SetTimer(Weapon.RefireTimer, &Weapon, &AHellWaveWeapon::FireCooldownExpired, Weapon.Archetype->RefireRate, false);
 	}
+};
+
+AHellWaveWeapon::AHellWaveWeapon()
+{
 }
 
-void AHellWaveWeapon::FireProjectile(const FVector& TargetLocation)
+void AHellWaveWeapon::BeginPlay()
 {
-	// Calculate spawn transform
-	FTransform ProjectileTransform = CalculateProjectileSpawnTransform(TargetLocation);
+	Super::BeginPlay();
 
-	// Spawn the projectile
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
-	SpawnParams.Owner = GetOwner();
-	SpawnParams.Instigator = PawnOwner;
+	// Archetype is resolved by the base class
+	ReserveAmmo = Archetype->StartingReserveAmmo;
 
-	GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	// Pick the fire pipeline specialized for the archetype
+	FirePipeline = SelectFirePipeline<>(*Archetype);
 
-	// Play firing montage and recoil
-	WeaponOwner->PlayFiringMontage(FiringMontage);
-	WeaponOwner->AddWeaponRecoil(FiringRecoil);
+	// Hitscan pellets test the world's hitbox capsules
+	HitboxSubsystem = GetWorld()->GetSubsystem<UHellWaveHitboxSubsystem>();
 
-	// Consume magazine ammo — NO auto-reload
-	--CurrentBullets;
+	// Hit impulses are batched per frame
+	ImpulseSubsystem = GetWorld()->GetSubsystem<UHellWaveImpulseSubsystem>();
 
-	// Update HUD
-	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
+	// Hit effects are pooled and budgeted
+	ImpactEffectsSubsystem = GetWorld()->GetSubsystem<UHellWaveImpactEffectsSubsystem>();
+
+	// Hit damage is resolved once per frame
+	DamageSubsystem = GetWorld()->GetSubsystem<UHellWaveDamageSubsystem>();
+}
+
+#if WITH_EDITOR
+void AHellWaveWeapon::GetFallbackTuning(FWeaponTableRow& OutRow) const
+{
+	Super::GetFallbackTuning(OutRow);
+
+	OutRow.MaxReserveAmmo = MaxReserveAmmo;
+	OutRow.StartingReserveAmmo = ReserveAmmo;
+	OutRow.bAutoReloadFromReserve = bAutoReloadFromReserve;
+	OutRow.ReloadTime = ReloadTime;
+	OutRow.HitscanRange = HitscanRange;
+	OutRow.HitscanDamage = HitscanDamage;
+	OutRow.HitscanImpulse = HitscanImpulse;
+	OutRow.HitscanDamageType = HitscanDamageType;
+	OutRow.bShouldFireHitscan = bShouldFireHitscan;
+}
+#endif // WITH_EDITOR
+
+void AHellWaveWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+	GetWorld()->GetTimerManager().ClearTimer(ReloadTimer);
+}
+
+void AHellWaveWeapon::Fire()
+{
+	FirePipeline(*this, 1);
+}
+
+void AHellWaveWeapon::FireBatch(int32 NumShots)
+{
+	FirePipeline(*this, NumShots);
+}
+
+template<typename TTraceMode, typename TPelletPattern, typename TAmmoModel, typename TRefireModel>
+void AHellWaveWeapon::FireWithPolicies(AHellWaveWeapon& Weapon, int32 NumShots)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HellWaveWeaponFire);
+
+	if (!Weapon.bIsFiring || Weapon.bIsReloading)
+	{
+		return;
+	}
+
+	// Check if we have ammo in the magazine
+	if (Weapon.CurrentBullets <= 0)
+	{
+		TAmmoModel::OnMagazineEmpty(Weapon);
+		return;
+	}
+
+	// A batch can't fire more rounds than the magazine holds
+	NumShots = FMath::Min(NumShots, Weapon.CurrentBullets);
+
+	INC_DWORD_STAT_BY(STAT_HellWaveWeaponShots, NumShots);
+
+	// Sample the aim once for the whole batch
+	const FShooterWeaponArchetype& Tuning = *Weapon.Archetype;
+	const FVector TargetLocation = Weapon.WeaponOwner->GetWeaponTargetLocation();
+	const FVector MuzzleLocation = Weapon.WeaponOwner->GetWeaponMuzzleLocation(&Weapon);
 
-	// If magazine is empty after firing, auto-reload from reserve
-	if (CurrentBullets <= 0 && ReserveAmmo > 0 && bAutoReloadFromReserve && !bFullAuto)
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
 	{
-		ReloadFromReserve();
+		// Place each shot between the last aim sample and this one
+		const float Alpha = Weapon.GetBatchShotAlpha(ShotIndex, NumShots);
+		const FVector ShotMuzzle = FMath::Lerp(Weapon.LastMuzzleLocation, MuzzleLocation, Alpha);
+		const FVector ShotTarget = FMath::Lerp(Weapon.LastAimTarget, TargetLocation, Alpha);
+		const FVector AimDir = (ShotTarget - ShotMuzzle).GetSafeNormal();
+		const float TargetDistance = FVector::Dist(ShotMuzzle, ShotTarget);
+
+		// Fire every pellet
+		TPelletPattern::ForEachPellet(Weapon, AimDir, [&Weapon, &ShotMuzzle, TargetDistance](const FVector& PelletDir)
+		{
+			TTraceMode::Shoot(Weapon, ShotMuzzle, PelletDir, TargetDistance);
+		});
+	}
+
+	Weapon.RecordAimSample(TargetLocation, MuzzleLocation);
+
+	// Play effects once per batch
+	Weapon.WeaponOwner->PlayFiringMontage(Weapon.GetFiringMontage());
+	Weapon.PlayFireSound(NumShots);
+	Weapon.WeaponOwner->AddWeaponRecoil(Tuning.FiringRecoil * NumShots);
+
+	// Consume the rounds
+	Weapon.CurrentBullets -= NumShots;
+
+	// Update HUD once per batch
+	Weapon.WeaponOwner->UpdateWeaponHUD(Weapon.CurrentBullets, Tuning.MagazineSize);
+
+	TAmmoModel::OnShotFired(Weapon);
+
+	// Update the time of our last shot
+	Weapon.TimeOfLastShot = Weapon.GetWorld()->GetTimeSeconds();
+
+	// Make noise for AI perception
+	Weapon.ReportShotNoise(Tuning.ShotLoudness, Tuning.ShotNoiseRange, Tuning.ShotNoiseTag);
+
+	TRefireModel::Schedule(Weapon);
+}
+
+template<typename... TChosenPolicies>
+AHellWaveWeapon::FFirePipeline AHellWaveWeapon::SelectFirePipeline(const FShooterWeaponArchetype& WeaponArchetype)
+{
+	constexpr int32 NumChosen = sizeof...(TChosenPolicies);
+
+	if constexpr (NumChosen == 0)
+	{
+		return WeaponArchetype.bShouldFireHitscan
+			? SelectFirePipeline<FHitscanTrace>(WeaponArchetype)
+			: SelectFirePipeline<FProjectileTrace>(WeaponArchetype);
+	}
+	else if constexpr (NumChosen == 1)
+	{
+		return WeaponArchetype.SpreadDirections.Num() > 0
+			? SelectFirePipeline<TChosenPolicies..., FPelletSpread>(WeaponArchetype)
+			: SelectFirePipeline<TChosenPolicies..., FSinglePellet>(WeaponArchetype);
+	}
+	else if constexpr (NumChosen == 2)
+	{
+		if (!WeaponArchetype.bAutoReloadFromReserve)
+		{
+			return SelectFirePipeline<TChosenPolicies..., TReserveAmmo<false, false>>(WeaponArchetype);
+		}
+
+		return WeaponArchetype.bFullAuto
+			? SelectFirePipeline<TChosenPolicies..., TReserveAmmo<true, false>>(WeaponArchetype)
+			: SelectFirePipeline<TChosenPolicies..., TReserveAmmo<true, true>>(WeaponArchetype);
+	}
+	else if constexpr (NumChosen == 3)
+	{
+		return WeaponArchetype.bFullAuto
+			? SelectFirePipeline<TChosenPolicies..., FFullAutoRefire>(WeaponArchetype)
+			: SelectFirePipeline<TChosenPolicies..., FSemiAutoRefire>(WeaponArchetype);
+	}
+	else
+	{
+		return &FireWithPolicies<TChosenPolicies...>;
 	}
 }
 
@@ -110,7 +328,7 @@ void AHellWaveWeapon::ReloadFromReserve()
 	bIsReloading = true;
 	StopFiring();
 
-	GetWorld()->GetTimerManager().SetTimer(ReloadTimer, this, &AHellWaveWeapon::OnReloadComplete, ReloadTime, false);
+	GetWorld()->GetTimerManager().SetTimer(ReloadTimer, this, &AHellWaveWeapon::OnReloadComplete, Archetype->ReloadTime, false);
 }
 
 void AHellWaveWeapon::OnReloadComplete()
@@ -118,84 +336,51 @@ void AHellWaveWeapon::OnReloadComplete()
 	bIsReloading = false;
 
 	// Transfer ammo from reserve to magazine
-	const int32 BulletsNeeded = MagazineSize - CurrentBullets;
+	const int32 BulletsNeeded = Archetype->MagazineSize - CurrentBullets;
 	const int32 BulletsToLoad = FMath::Min(BulletsNeeded, ReserveAmmo);
 
 	CurrentBullets += BulletsToLoad;
 	ReserveAmmo -= BulletsToLoad;
 
 	// Update HUD
-	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
+	WeaponOwner->UpdateWeaponHUD(CurrentBullets, Archetype->MagazineSize);
 }
 
-void AHellWaveWeapon::FireHitscan(const FVector& TargetLocation)
+void AHellWaveWeapon::ProcessHitscan(const FHitResult& HitResult, const FVector& ShotDirection, float DamageMultiplier)
 {
-	FHitResult HitResult;
-	const FVector MuzzleLoc = GetFirstPersonMesh()->GetSocketLocation(MuzzleSocketName);
-	const FVector TraceDir = (TargetLocation - MuzzleLoc).GetSafeNormal();
-	const FVector TraceStart = MuzzleLoc + (TraceDir * MuzzleOffset);
-	
-	GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceStart + (TraceDir * HitscanRange), ECC_Visibility);
-	
-	if (HitResult.bBlockingHit)
-	{
-		ProcessHitscan(HitResult, TraceDir);
-	}
-	
-	// Play firing montage and recoil
-	WeaponOwner->PlayFiringMontage(FiringMontage);
-	WeaponOwner->AddWeaponRecoil(FiringRecoil);
+	// have we hit a character? Hits on geometry without an owning actor fall through to the effects
+	ACharacter* HitCharacter = Cast<ACharacter>(HitResult.GetActor());
 
-	// Consume magazine ammo — NO auto-reload
-	--CurrentBullets;
-
-	// Update HUD
-	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
-
-	// If magazine is empty after firing, auto-reload from reserve
-	if (CurrentBullets <= 0 && ReserveAmmo > 0 && bAutoReloadFromReserve && !bFullAuto)
+	// ignore the owner of this weapon
+	if (HitCharacter && HitCharacter != GetOwner())
 	{
-		ReloadFromReserve();
-	}
-}
-
-void AHellWaveWeapon::ProcessHitscan(const FHitResult& HitResult, const FVector& ShotDirection)
-{
-	UE_LOG(LogTemp, Warning, TEXT("In ProcessHitscan"));
-	UE_LOG(LogTemp, Warning, TEXT("Hit actor: %s, Class: %s"),
-		  *HitResult.GetActor()->GetName(),
-		  *HitResult.GetActor()->GetClass()->GetName());	
-	
-	// have we hit a character?
-	if (ACharacter* HitCharacter = Cast<ACharacter>(HitResult.GetActor()))
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Hitscan hit character: %s"), *HitCharacter->GetName());
-		
-		// ignore the owner of this projectile
-		if (HitCharacter != GetOwner())
+		// queue damage to the character. Pellet hits are summed and resolved once per frame
+		if (DamageSubsystem)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Owner: %s"), *(GetOwner()->GetName()));
-			// apply damage to the character
-			UGameplayStatics::ApplyDamage(
+			DamageSubsystem->QueueDamage(
 				HitCharacter, 
-				HitscanDamage, 
+				Archetype->HitscanDamage * DamageMultiplier, 
 				GetInstigatorController(), 
 				this, 
-				HitscanDamageType
+				Archetype->HitscanDamageType
 			);
 		}
 	}
 
-	// have we hit a physics object?
-	UPrimitiveComponent* HitComp = HitResult.GetComponent();
-	if (HitComp->IsSimulatingPhysics())
+	// queue the impact effects. Nearby impacts are merged and played once per frame
+	if (ImpactEffectsSubsystem)
+	{
+		ImpactEffectsSubsystem->RequestImpact(HitResult);
+	}
+
+	// push physics objects. Impulses are summed and applied once per frame
+	if (ImpulseSubsystem)
 	{
-		// give some physics impulse to the object
-		HitComp->AddImpulseAtLocation(ShotDirection * HitscanImpulse, HitResult.ImpactPoint);
+		ImpulseSubsystem->AddImpulseAtLocation(HitResult.GetComponent(), ShotDirection * Archetype->HitscanImpulse, HitResult.ImpactPoint, HitResult.BoneName);
 	}
 }
 
 void AHellWaveWeapon::AddReserveAmmo(int32 Amount)
 {
-	ReserveAmmo = FMath::Min(ReserveAmmo + Amount, MaxReserveAmmo);
+	ReserveAmmo = FMath::Min(ReserveAmmo + Amount, Archetype->MaxReserveAmmo);
 }
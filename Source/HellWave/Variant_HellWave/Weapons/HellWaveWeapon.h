@@ -6,10 +6,18 @@
 #include "ShooterWeapon.h"
 #include "HellWaveWeapon.generated.h"
 
+class UHellWaveHitboxSubsystem;
+class UHellWaveImpulseSubsystem;
+class UHellWaveImpactEffectsSubsystem;
+class UHellWaveDamageSubsystem;
+
 /**
  *  Base weapon for HellWave variant
  *  Overrides the auto-reload system with a reserve ammo pool
  *  Weapons cannot fire when both magazine and reserve ammo are depleted
+ *  Reserve, reload and hitscan tuning come from the weapon archetype
+ *  Every weapon type fires through one shared pipeline, assembled from policies for the
+ *  archetype's trace mode, pellet pattern, ammo model and refire model
  */
 UCLASS(abstract)
 class HELLWAVE_API AHellWaveWeapon : public AShooterWeapon
@@ -18,46 +26,92 @@ class HELLWAVE_API AHellWaveWeapon : public AShooterWeapon
 	
 protected:
 
-	/** Maximum reserve ammo capacity */
-	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 500))
-	int32 MaxReserveAmmo = 50;
-
-	/** Current reserve ammo count */
-	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 500))
+	/** Current reserve ammo count. Starts at the archetype's starting reserve. The default is the fallback starting reserve for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Ammo", meta = (ClampMin = 0, ClampMax = 500))
 	int32 ReserveAmmo = 50;
 
-	/** If true, weapon will auto-reload from reserve when magazine is empty and trigger is released */
-	UPROPERTY(EditAnywhere, Category="Ammo")
-	bool bAutoReloadFromReserve = true;
+#if WITH_EDITORONLY_DATA
+	// Deprecated tuning, editor only. Baked into a data table row on cook for weapons that have none
 
-	/** Time to reload from reserve */
-	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
-	float ReloadTime = 0.5f;
+	/** Maximum reserve ammo capacity. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Ammo", meta = (ClampMin = 0, ClampMax = 500))
+	int32 MaxReserveAmmo = 50;
 
-	/** True while reloading */
-	bool bIsReloading = false;
+	/** If true, weapon will auto-reload from reserve when magazine is empty. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Ammo")
+	bool bAutoReloadFromReserve = true;
 
-	FTimerHandle ReloadTimer;
+	/** Time to reload from reserve. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Ammo", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float ReloadTime = 0.5f;
 
-	UPROPERTY(EditDefaultsOnly, Category="Sound")
-	USoundBase* DryFireSound;
-	
-	// -- Hit Scan --
-	
+	/** Max distance of hitscan traces. Fallback for weapons without an archetype row */
 	UPROPERTY(EditDefaultsOnly, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 50000, Units = "cm"))
 	float HitscanRange = 5000.0f;
-	
+
+	/** Damage dealt per hitscan hit. Fallback for weapons without an archetype row */
 	UPROPERTY(EditDefaultsOnly, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 500))
 	float HitscanDamage = 25.0f;
-	
+
+	/** Impulse applied to simulating bodies on hit. Fallback for weapons without an archetype row */
 	UPROPERTY(EditDefaultsOnly, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 50000))
 	float HitscanImpulse = 100.0f;
-	
+
+	/** Damage type for hitscan hits. Fallback for weapons without an archetype row */
 	UPROPERTY(EditDefaultsOnly, Category="Hitscan")
 	TSubclassOf<UDamageType> HitscanDamageType;
-	
+
+	/** If true, fires hitscan traces instead of projectiles. Fallback for weapons without an archetype row */
 	UPROPERTY(EditDefaultsOnly, Category="Hitscan")
 	bool bShouldFireHitscan = true;
+#endif // WITH_EDITORONLY_DATA
+
+	/** True while reloading */
+	bool bIsReloading = false;
+
+	/** Number of spread shots fired. Picks the next precomputed spread layout, so shots replay identically */
+	uint32 SpreadShotIndex = 0;
+
+	FTimerHandle ReloadTimer;
+
+	UPROPERTY(EditDefaultsOnly, Category="Sound")
+	USoundBase* DryFireSound;
+
+	/** Fire pipeline assembled for this weapon's archetype. Fires a batch of trigger pulls */
+	using FFirePipeline = void (*)(AHellWaveWeapon& Weapon, int32 NumShots);
+
+	/** Fire pipeline for this weapon. Selected on BeginPlay */
+	FFirePipeline FirePipeline = nullptr;
+
+	/** Hitbox capsules hitscan pellets are tested against */
+	TObjectPtr<UHellWaveHitboxSubsystem> HitboxSubsystem;
+
+	/** Accumulates hit impulses for the frame */
+	TObjectPtr<UHellWaveImpulseSubsystem> ImpulseSubsystem;
+
+	/** Plays pooled impact effects for hits */
+	TObjectPtr<UHellWaveImpactEffectsSubsystem> ImpactEffectsSubsystem;
+
+	/** Resolves hit damage once per frame */
+	TObjectPtr<UHellWaveDamageSubsystem> DamageSubsystem;
+
+	// Fire pipeline policies. Defined in HellWaveWeapon.cpp
+
+	/** Trace modes: fire a hitscan trace or spawn a projectile along a pellet direction */
+	struct FHitscanTrace;
+	struct FProjectileTrace;
+
+	/** Pellet patterns: one pellet along the aim, or the archetype's precomputed spread rotated into the aim frame */
+	struct FSinglePellet;
+	struct FPelletSpread;
+
+	/** Ammo model: what happens on an empty magazine, and whether to reload as soon as a shot empties it */
+	template<bool bAutoReload, bool bReloadWhenEmptied>
+	struct TReserveAmmo;
+
+	/** Refire models: leave full auto refire to the tick scheduler, or schedule the semi auto cooldown */
+	struct FFullAutoRefire;
+	struct FSemiAutoRefire;
 	
 public:
 
@@ -65,25 +119,40 @@ public:
 
 protected:
 
-	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+	/** Fills the reserve from the archetype */
+	virtual void BeginPlay() override;
 
-	/** Overridden to use reserve ammo instead of auto-reload */
-	virtual void FireProjectile(const FVector& TargetLocation) override;
+#if WITH_EDITOR
+	/** Adds the reserve, reload and hitscan properties to the fallback tuning */
+	virtual void GetFallbackTuning(FWeaponTableRow& OutRow) const override;
+#endif // WITH_EDITOR
 
-	/** Overridden to check ammo before firing */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+	/** Overridden to run the specialized fire pipeline */
 	virtual void Fire() override;
 
+	/** Overridden to run the specialized fire pipeline for a batch of full auto shots */
+	virtual void FireBatch(int32 NumShots) override;
+
+	/** Fires a batch of trigger pulls with the given policies */
+	template<typename TTraceMode, typename TPelletPattern, typename TAmmoModel, typename TRefireModel>
+	static void FireWithPolicies(AHellWaveWeapon& Weapon, int32 NumShots);
+
+	/** Picks the fire pipeline matching the archetype, choosing one policy per call */
+	template<typename... TChosenPolicies>
+	static FFirePipeline SelectFirePipeline(const FShooterWeaponArchetype& WeaponArchetype);
+
 	/** Reload magazine from reserve */
 	void ReloadFromReserve();
 
 	/** Called when reload is complete */
 	void OnReloadComplete();
 	
-	virtual void FireHitscan(const FVector& TargetLocation);
-	
-	void ProcessHitscan(const FHitResult& Hit, const FVector& ShotDirection);
+	/** Applies hitscan damage and impulse. Hitbox hits scale the damage by their zone multiplier */
+	void ProcessHitscan(const FHitResult& Hit, const FVector& ShotDirection, float DamageMultiplier = 1.0f);
 	
-	/** Blueprint event for pre-hit effects (decals, particles, sounds) */
+	/** Blueprint event for extra hit effects. Impact particles, decals and sounds are played by the impact effects subsystem */
 	UFUNCTION(BlueprintImplementableEvent, Category="Hitscan", meta = (DisplayName = "On Hitscan Hit"))
 	void BP_OnHitscanHit(const FHitResult& Hit);
 
@@ -96,7 +165,7 @@ public:
 	int32 GetReserveAmmo() const { return ReserveAmmo; }
 
 	/** Returns max reserve ammo */
-	int32 GetMaxReserveAmmo() const { return MaxReserveAmmo; }
+	int32 GetMaxReserveAmmo() const { return Archetype->MaxReserveAmmo; }
 
 	/** Returns true if the weapon has any ammo (magazine + reserve) */
 	bool HasAmmo() const { return CurrentBullets > 0 || ReserveAmmo > 0; }
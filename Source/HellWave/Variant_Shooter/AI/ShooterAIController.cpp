@@ -29,8 +29,8 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 	// ensure we're possessing an NPC
 	if (AShooterNPC* NPC = Cast<AShooterNPC>(InPawn))
 	{
-		// add the team tag to the pawn
-		NPC->Tags.Add(TeamTag);
+		// share the pawn's team so perception affiliation filtering matches it
+		SetGenericTeamId(NPC->GetGenericTeamId());
 
 		// subscribe to the pawn's OnDeath delegate
 		NPC->OnPawnDeath.AddDynamic(this, &AShooterAIController::OnPawnDeath);
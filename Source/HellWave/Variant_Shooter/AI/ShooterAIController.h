@@ -31,10 +31,6 @@ class HELLWAVE_API AShooterAIController : public AAIController
 
 protected:
 
-	/** Team tag for pawn friend or foe identification */
-	UPROPERTY(EditAnywhere, Category="Shooter")
-	FName TeamTag = FName("Enemy");
-
 	/** Enemy currently being targeted */
 	TObjectPtr<AActor> TargetEnemy;
 
@@ -5,24 +5,93 @@
 #include "ShooterWeapon.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterGameMode.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
 #include "TimerManager.h"
+#include "HellWaveArenaDataSubsystem.h"
+#include "ShooterNPCArchetype.h"
+#include "HellWaveTeamComponent.h"
+#include "HellWaveHitboxComponent.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/Package.h"
+#include "HellWave.h"
+
+#if WITH_EDITOR
+#include "Misc/DataValidation.h"
+#endif
+
+namespace
+{
+	/** Console command to print the measured NPC memory. Takes an optional projected NPC count */
+	FAutoConsoleCommandWithWorldAndArgs NPCMemoryCommand(
+		TEXT("HellWave.NPCMemory"),
+		TEXT("Logs the measured memory of live NPCs and their shared archetypes, and the cost of per-NPC tuning copies at a projected count. Usage: HellWave.NPCMemory [ProjectedCount]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			AShooterNPC::LogMemoryFootprint(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200);
+		}));
+}
+
+AShooterNPC::AShooterNPC()
+{
+	// lean collision: the capsule blocks movement and projectiles, the mesh only answers hitscan
+	GetCapsuleComponent()->SetCollisionProfileName(FName("HellWaveEnemyCapsule"));
+	GetMesh()->SetCollisionProfileName(FName("HellWaveEnemyMesh"));
+
+	// nothing listens to NPC overlaps
+	GetCapsuleComponent()->SetGenerateOverlapEvents(false);
+	GetMesh()->SetGenerateOverlapEvents(false);
+
+	// publish hitbox capsules so hitscan pellets skip the physics asset
+	HitboxComponent = CreateDefaultSubobject<UHellWaveHitboxComponent>(TEXT("Hitboxes"));
+}
+
+void AShooterNPC::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (!Archetype && GetWorld() && GetWorld()->IsGameWorld())
+	{
+#if WITH_EDITOR
+		// NPCs that haven't been given an archetype asset share one built from the tuning set on their Blueprint
+		Archetype = FindOrAddFallbackArchetype(GetClass()->GetDefaultObject<AShooterNPC>());
+#else
+		UE_LOG(LogHellWave, Error, TEXT("%s has no NPC archetype and will use default tuning. Assign an archetype asset to its class."), *GetClass()->GetName());
+#endif
+	}
+
+	// join the archetype's team before an AI controller possesses us and copies it
+	GetTeamComponent()->SetTeamId(FGenericTeamId(GetArchetype().TeamByte));
+}
 
 void AShooterNPC::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// start somewhere different in the shared aim table. Spawn order is stable between runs, so shots still replay identically.
+	// the odd stride spreads consecutive NPCs across the whole table
+	if (AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()))
+	{
+		AimShotIndex = GM->ClaimNPCSpawnIndex() * 37u;
+	}
+
 	// spawn the weapon
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.Owner = this;
 	SpawnParams.Instigator = this;
 	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
-	Weapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+	Weapon = GetWorld()->SpawnActor<AShooterWeapon>(GetArchetype().WeaponClass, GetActorTransform(), SpawnParams);
+
+	if (!Weapon)
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("%s has no weapon class set and will not shoot."), *GetName());
+	}
 }
 
 void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -35,8 +104,8 @@ void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// ignore if already dead
-	if (bIsDead)
+	// ignore if already dead or hit by a teammate
+	if (IsDead() || GetTeamComponent()->ShouldIgnoreDamageFrom(EventInstigator ? EventInstigator->GetPawn() : DamageCauser))
 	{
 		return 0.0f;
 	}
@@ -56,13 +125,14 @@ float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEve
 void AShooterNPC::AttachWeaponMeshes(AShooterWeapon* WeaponToAttach)
 {
 	const FAttachmentTransformRules AttachmentRule(EAttachmentRule::SnapToTarget, false);
+	const UShooterNPCArchetype& Tuning = GetArchetype();
 
 	// attach the weapon actor
 	WeaponToAttach->AttachToActor(this, AttachmentRule);
 
 	// attach the weapon meshes
-	WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, FirstPersonWeaponSocket);
-	WeaponToAttach->GetThirdPersonMesh()->AttachToComponent(GetMesh(), AttachmentRule, ThirdPersonWeaponSocket);
+	WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, Tuning.FirstPersonWeaponSocket);
+	WeaponToAttach->GetThirdPersonMesh()->AttachToComponent(GetMesh(), AttachmentRule, Tuning.ThirdPersonWeaponSocket);
 }
 
 void AShooterNPC::PlayFiringMontage(UAnimMontage* Montage)
@@ -84,9 +154,15 @@ FVector AShooterNPC::GetWeaponTargetLocation()
 {
 	// start aiming from the camera location
 	const FVector AimSource = GetFirstPersonCameraComponent()->GetComponentLocation();
+	const UShooterNPCArchetype& Tuning = GetArchetype();
 
 	FVector AimDir, AimTarget = FVector::ZeroVector;
 
+	// pick the next precomputed aim sample
+	FVector AimVariance;
+	float AimOffsetZ = 0.0f;
+	Tuning.GetAimSample(AimShotIndex++, AimVariance, AimOffsetZ);
+
 	// do we have an aim target?
 	if (CurrentAimTarget)
 	{
@@ -94,30 +170,42 @@ FVector AShooterNPC::GetWeaponTargetLocation()
 		AimTarget = CurrentAimTarget->GetActorLocation();
 
 		// apply a vertical offset to target head/feet
-		AimTarget.Z += FMath::RandRange(MinAimOffsetZ, MaxAimOffsetZ);
+		AimTarget.Z += AimOffsetZ;
 
-		// get the aim direction and apply randomness in a cone
-		AimDir = (AimTarget - AimSource).GetSafeNormal();
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(AimDir, AimVarianceHalfAngle);
+		// rotate the cone variance into the aim direction
+		AimDir = (AimTarget - AimSource).GetSafeNormal().ToOrientationQuat().RotateVector(AimVariance);
 
 		
 	} else {
 
 		// no aim target, so just use the camera facing
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(GetFirstPersonCameraComponent()->GetForwardVector(), AimVarianceHalfAngle);
+		AimDir = GetFirstPersonCameraComponent()->GetComponentQuat().RotateVector(AimVariance);
+
+	}
 
+	// if the baked visibility grid proved the line to the target is blocked, skip the trace.
+	// the shot will still collide with the blocking geometry along the same line
+	if (CurrentAimTarget)
+	{
+		const FVector TargetDistancePoint = AimSource + (AimDir * FVector::Dist(AimSource, AimTarget));
+
+		UHellWaveArenaDataSubsystem* ArenaData = GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>();
+		if (ArenaData && !ArenaData->ShouldTraceVisibility(AimSource, TargetDistancePoint))
+		{
+			return TargetDistancePoint;
+		}
 	}
 
 	// calculate the unobstructed aim target location
-	AimTarget = AimSource + (AimDir * AimRange);
+	AimTarget = AimSource + (AimDir * Tuning.AimRange);
 
-	// run a visibility trace to see if there's obstructions
+	// run a hitscan trace to see if there's obstructions
 	FHitResult OutHit;
 
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
-	GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, AimTarget, ECC_Visibility, QueryParams);
+	GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, AimTarget, ECC_HellWaveHitscan, QueryParams);
 
 	// return either the impact point or the trace end
 	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
@@ -141,26 +229,74 @@ void AShooterNPC::OnWeaponDeactivated(AShooterWeapon* InWeapon)
 void AShooterNPC::OnSemiWeaponRefire()
 {
 	// are we still shooting?
-	if (bIsShooting)
+	if (bIsShooting && Weapon)
 	{
 		// fire the weapon
 		Weapon->StartFiring();
 	}
 }
 
+#if WITH_EDITOR
+UShooterNPCArchetype* AShooterNPC::FindOrAddFallbackArchetype(const AShooterNPC* NPCDefaults)
+{
+	// one per class. The NPCs pointing at it keep it alive, and it's rebuilt if they're all gone
+	static TMap<TObjectKey<UClass>, TWeakObjectPtr<UShooterNPCArchetype>> FallbackArchetypes;
+
+	TWeakObjectPtr<UShooterNPCArchetype>& Fallback = FallbackArchetypes.FindOrAdd(NPCDefaults->GetClass());
+
+	if (!Fallback.IsValid())
+	{
+		UShooterNPCArchetype* NewFallback = NewObject<UShooterNPCArchetype>(GetTransientPackage(), NAME_None, RF_Transient);
+
+		NewFallback->RagdollCollisionProfile = NPCDefaults->RagdollCollisionProfile;
+		NewFallback->DeferredDestructionTime = NPCDefaults->DeferredDestructionTime;
+		NewFallback->TeamByte = NPCDefaults->TeamByte;
+		NewFallback->WeaponClass = NPCDefaults->WeaponClass;
+		NewFallback->FirstPersonWeaponSocket = NPCDefaults->FirstPersonWeaponSocket;
+		NewFallback->ThirdPersonWeaponSocket = NPCDefaults->ThirdPersonWeaponSocket;
+		NewFallback->AimRange = NPCDefaults->AimRange;
+		NewFallback->AimVarianceHalfAngle = NPCDefaults->AimVarianceHalfAngle;
+		NewFallback->MinAimOffsetZ = NPCDefaults->MinAimOffsetZ;
+		NewFallback->MaxAimOffsetZ = NPCDefaults->MaxAimOffsetZ;
+
+		// the aim tables were built from the defaults on construction
+		NewFallback->BuildAimTables();
+
+		UE_LOG(LogHellWave, Warning, TEXT("%s has no NPC archetype. Its NPCs share a fallback built from its deprecated tuning until an archetype asset is assigned."), *NPCDefaults->GetClass()->GetName());
+
+		Fallback = NewFallback;
+	}
+
+	return Fallback.Get();
+}
+
+EDataValidationResult AShooterNPC::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = Super::IsDataValid(Context);
+
+	// only the class defaults matter, placed NPCs inherit their archetype from them
+	if (HasAnyFlags(RF_ClassDefaultObject) && !GetClass()->HasAnyClassFlags(CLASS_Abstract) && !Archetype)
+	{
+		Context.AddError(FText::FromString(FString::Printf(TEXT("%s has no NPC archetype asset. Cooked builds drop the deprecated tuning and would use default tuning."), *GetClass()->GetName())));
+		Result = EDataValidationResult::Invalid;
+	}
+
+	return Result;
+}
+#endif // WITH_EDITOR
+
 void AShooterNPC::Die()
 {
 	// ignore if already dead
-	if (bIsDead)
+	if (IsDead())
 	{
 		return;
 	}
 
 	// raise the dead flag
-	bIsDead = true;
+	GetTeamComponent()->MarkDead();
 
-	// grant the death tag to the character
-	Tags.Add(DeathTag);
+	const UShooterNPCArchetype& Tuning = GetArchetype();
 
 	// call the delegate
 	OnPawnDeath.Broadcast();
@@ -168,7 +304,7 @@ void AShooterNPC::Die()
 	// increment the team score
 	if (AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()))
 	{
-		GM->IncrementTeamScore(TeamByte);
+		GM->IncrementTeamScore(Tuning.TeamByte);
 	}
 
 	// disable capsule collision
@@ -179,12 +315,17 @@ void AShooterNPC::Die()
 	GetCharacterMovement()->StopActiveMovement();
 
 	// enable ragdoll physics on the third person mesh
-	GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
+	GetMesh()->SetCollisionProfileName(Tuning.RagdollCollisionProfile);
 	GetMesh()->SetSimulatePhysics(true);
 	GetMesh()->SetPhysicsBlendWeight(1.0f);
 
 	// schedule actor destruction
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
+	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, Tuning.DeferredDestructionTime, false);
+}
+
+bool AShooterNPC::IsDead() const
+{
+	return GetTeamComponent()->IsDead();
 }
 
 void AShooterNPC::DeferredDestruction()
@@ -201,7 +342,10 @@ void AShooterNPC::StartShooting(AActor* ActorToShoot)
 	bIsShooting = true;
 
 	// signal the weapon
-	Weapon->StartFiring();
+	if (Weapon)
+	{
+		Weapon->StartFiring();
+	}
 }
 
 void AShooterNPC::StopShooting()
@@ -210,5 +354,61 @@ void AShooterNPC::StopShooting()
 	bIsShooting = false;
 
 	// signal the weapon
-	Weapon->StopFiring();
+	if (Weapon)
+	{
+		Weapon->StopFiring();
+	}
+}
+
+const UShooterNPCArchetype& AShooterNPC::GetArchetype() const
+{
+	return Archetype ? *Archetype : *GetDefault<UShooterNPCArchetype>();
+}
+
+void AShooterNPC::LogMemoryFootprint(UWorld* World, int32 ProjectedCount)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	// measure the live NPCs and the distinct archetypes they share.
+	// the counting archive includes the object itself and its reflected container allocations
+	int32 NumNPCs = 0;
+	int64 InstanceBytes = 0;
+	TSet<const UShooterNPCArchetype*> SharedArchetypes;
+
+	for (TActorIterator<AShooterNPC> It(World); It; ++It)
+	{
+		++NumNPCs;
+		InstanceBytes += FArchiveCountMem(*It).GetMax();
+		SharedArchetypes.Add(&It->GetArchetype());
+	}
+
+	int64 ArchetypeBytes = 0;
+
+	for (const UShooterNPCArchetype* SharedArchetype : SharedArchetypes)
+	{
+		// the aim tables aren't reflected, so add them by hand
+		ArchetypeBytes += FArchiveCountMem(const_cast<UShooterNPCArchetype*>(SharedArchetype)).GetMax();
+		ArchetypeBytes += SharedArchetype->AimDirections.GetAllocatedSize() + SharedArchetype->AimOffsetsZ.GetAllocatedSize();
+	}
+
+	if (NumNPCs == 0)
+	{
+		UE_LOG(LogHellWave, Log, TEXT("NPC memory: no live NPCs to measure."));
+		return;
+	}
+
+	const int64 AverageInstanceBytes = InstanceBytes / NumNPCs;
+	const int64 AverageArchetypeBytes = ArchetypeBytes / SharedArchetypes.Num();
+
+	// shared tuning costs one archetype per type. Per-NPC tuning would cost a copy of it on every NPC
+	const int64 SharedBytes = int64(ProjectedCount) * AverageInstanceBytes + ArchetypeBytes;
+	const int64 CopiedBytes = int64(ProjectedCount) * (AverageInstanceBytes + AverageArchetypeBytes);
+
+	UE_LOG(LogHellWave, Log, TEXT("NPC memory: %d live NPCs measured at %.1f KB (%lld bytes each), sharing %d archetypes measured at %.1f KB."),
+		NumNPCs, InstanceBytes / 1024.0, AverageInstanceBytes, SharedArchetypes.Num(), ArchetypeBytes / 1024.0);
+	UE_LOG(LogHellWave, Log, TEXT("NPC memory at %d NPCs: %.1f KB with shared archetypes, %.1f KB if each NPC owned a copy of its tuning, %.1f KB saved."),
+		ProjectedCount, SharedBytes / 1024.0, CopiedBytes / 1024.0, (CopiedBytes - SharedBytes) / 1024.0);
 }
@@ -10,17 +10,24 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPawnDeathDelegate);
 
 class AShooterWeapon;
+class UShooterNPCArchetype;
+class UHellWaveHitboxComponent;
 
 /**
  *  A simple AI-controlled shooter game NPC
  *  Executes its behavior through a StateTree managed by its AI Controller
  *  Holds and manages a weapon
+ *  Immutable per-type tuning lives in a shared UShooterNPCArchetype
  */
 UCLASS(abstract)
 class HELLWAVE_API AShooterNPC : public AHellWaveCharacter, public IShooterWeaponHolder
 {
 	GENERATED_BODY()
 
+	/** Bone driven capsules that hitscan weapons test instead of the mesh */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UHellWaveHitboxComponent* HitboxComponent;
+
 public:
 
 	/** Current HP for this character. It dies if it reaches zero through damage */
@@ -29,52 +36,56 @@ public:
 
 protected:
 
-	/** Name of the collision profile to use during ragdoll death */
-	UPROPERTY(EditAnywhere, Category="Damage")
+	/** Shared tuning for this type of NPC. Required for cooked builds, which fall back to the default archetype without it */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Archetype")
+	TObjectPtr<UShooterNPCArchetype> Archetype;
+
+#if WITH_EDITORONLY_DATA
+	// Deprecated tuning, editor only. In the editor, NPCs without an archetype asset share one fallback archetype per class built from these
+
+	/** Name of the collision profile to use during ragdoll death. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Damage")
 	FName RagdollCollisionProfile = FName("Ragdoll");
 
-	/** Time to wait after death before destroying this actor */
-	UPROPERTY(EditAnywhere, Category="Damage")
+	/** Time to wait after death before destroying this actor. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Damage")
 	float DeferredDestructionTime = 5.0f;
 
-	/** Team byte for this character */
-	UPROPERTY(EditAnywhere, Category="Team")
+	/** Team byte for this character. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Team")
 	uint8 TeamByte = 1;
 
-	/** Actor tag to grant this character when it dies */
-	UPROPERTY(EditAnywhere, Category="Team")
-	FName DeathTag = FName("Dead");
-
-	/** Pointer to the equipped weapon */
-	TObjectPtr<AShooterWeapon> Weapon;
-
-	/** Type of weapon to spawn for this character */
-	UPROPERTY(EditAnywhere, Category="Weapon")
+	/** Type of weapon to spawn for this character. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Weapon")
 	TSubclassOf<AShooterWeapon> WeaponClass;
 
-	/** Name of the first person mesh weapon socket */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category ="Weapons")
+	/** Name of the first person mesh weapon socket. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category ="Weapons")
 	FName FirstPersonWeaponSocket = FName("HandGrip_R");
 
-	/** Name of the third person mesh weapon socket */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category ="Weapons")
+	/** Name of the third person mesh weapon socket. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category ="Weapons")
 	FName ThirdPersonWeaponSocket = FName("HandGrip_R");
 
-	/** Max range for aiming calculations */
-	UPROPERTY(EditAnywhere, Category="Aim")
+	/** Max range for aiming calculations. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Aim")
 	float AimRange = 10000.0f;
 
-	/** Cone variance to apply while aiming */
-	UPROPERTY(EditAnywhere, Category="Aim")
+	/** Cone variance to apply while aiming. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Aim")
 	float AimVarianceHalfAngle = 10.0f;
 
-	/** Minimum vertical offset from the target center to apply when aiming */
-	UPROPERTY(EditAnywhere, Category="Aim")
+	/** Minimum vertical offset from the target center to apply when aiming. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Aim")
 	float MinAimOffsetZ = -35.0f;
 
-	/** Maximum vertical offset from the target center to apply when aiming */
-	UPROPERTY(EditAnywhere, Category="Aim")
+	/** Maximum vertical offset from the target center to apply when aiming. Fallback for NPCs without an archetype */
+	UPROPERTY(EditDefaultsOnly, Category="Aim")
 	float MaxAimOffsetZ = -60.0f;
+#endif // WITH_EDITORONLY_DATA
+
+	/** Pointer to the equipped weapon */
+	TObjectPtr<AShooterWeapon> Weapon;
 
 	/** Actor currently being targeted */
 	TObjectPtr<AActor> CurrentAimTarget;
@@ -82,8 +93,8 @@ protected:
 	/** If true, this character is currently shooting its weapon */
 	bool bIsShooting = false;
 
-	/** If true, this character has already died */
-	bool bIsDead = false;
+	/** Picks the next precomputed aim sample. Starts at an offset seeded from the NPC's spawn order, so NPCs sharing an archetype don't aim in lockstep */
+	uint32 AimShotIndex = 0;
 
 	/** Deferred destruction on death timer */
 	FTimerHandle DeathTimer;
@@ -93,8 +104,14 @@ public:
 	/** Delegate called when this NPC dies */
 	FPawnDeathDelegate OnPawnDeath;
 
+	/** Constructor */
+	AShooterNPC();
+
 protected:
 
+	/** Picks up the class's fallback archetype if needed and applies the archetype team */
+	virtual void PostInitializeComponents() override;
+
 	/** Gameplay initialization */
 	virtual void BeginPlay() override;
 
@@ -139,8 +156,18 @@ public:
 
 	//~End IShooterWeaponHolder interface
 
+#if WITH_EDITOR
+	/** Flags NPC classes without an archetype asset, since cooked builds can't build a fallback for them */
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
+#endif // WITH_EDITOR
+
 protected:
 
+#if WITH_EDITOR
+	/** Returns the archetype shared by every NPC of the class, built from its deprecated tuning properties on first use. Pass the class default object */
+	static UShooterNPCArchetype* FindOrAddFallbackArchetype(const AShooterNPC* NPCDefaults);
+#endif // WITH_EDITOR
+
 	/** Called when HP is depleted and the character should die */
 	void Die();
 
@@ -154,4 +181,14 @@ public:
 
 	/** Signals this character to stop shooting */
 	void StopShooting();
+
+	/** Returns true if this character has died */
+	bool IsDead() const;
+
+	/** Returns the shared tuning for this NPC */
+	const UShooterNPCArchetype& GetArchetype() const;
+
+	/** Logs the measured memory of the live NPCs and of the archetypes they share, and what per-NPC copies of that tuning would cost at the projected count.
+	 *  Sizes come from a memory counting archive, so they include container allocations */
+	static void LogMemoryFootprint(UWorld* World, int32 ProjectedCount = 200);
 };
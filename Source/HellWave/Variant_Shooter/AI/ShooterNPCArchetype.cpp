@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterNPCArchetype.h"
+
+void UShooterNPCArchetype::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	BuildAimTables();
+}
+
+void UShooterNPCArchetype::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildAimTables();
+}
+
+#if WITH_EDITOR
+void UShooterNPCArchetype::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildAimTables();
+}
+#endif
+
+void UShooterNPCArchetype::GetAimSample(uint32 ShotIndex, FVector& OutDirection, float& OutOffsetZ) const
+{
+	const int32 SampleIndex = ShotIndex % NumAimSamples;
+
+	OutDirection = AimDirections[SampleIndex];
+	OutOffsetZ = AimOffsetsZ[SampleIndex];
+}
+
+void UShooterNPCArchetype::BuildAimTables()
+{
+	FRandomStream Stream(AimSeed);
+
+	AimDirections.SetNumUninitialized(NumAimSamples);
+	AimOffsetsZ.SetNumUninitialized(NumAimSamples);
+
+	const float HalfAngleRad = FMath::DegreesToRadians(AimVarianceHalfAngle);
+
+	for (int32 SampleIndex = 0; SampleIndex < NumAimSamples; ++SampleIndex)
+	{
+		// uniform direction in the variance cone, with X forward
+		AimDirections[SampleIndex] = Stream.VRandCone(FVector::ForwardVector, HalfAngleRad);
+		AimOffsetsZ[SampleIndex] = Stream.FRandRange(MinAimOffsetZ, MaxAimOffsetZ);
+	}
+}
@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterNPCArchetype.generated.h"
+
+class AShooterWeapon;
+
+/**
+ *  Immutable tuning for a type of shooter NPC
+ *  Shared by every NPC of the type, so each NPC only carries a pointer to it
+ *  Aim variance is precomputed from a seed, so NPC shots are reproducible
+ */
+UCLASS(BlueprintType)
+class HELLWAVE_API UShooterNPCArchetype : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Name of the collision profile to use during ragdoll death */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage")
+	FName RagdollCollisionProfile = FName("Ragdoll");
+
+	/** Time to wait after death before destroying the NPC */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage", meta = (ClampMin = 0, Units = "s"))
+	float DeferredDestructionTime = 5.0f;
+
+	/** Team byte for NPCs of this type. Also the NPC's generic team ID */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Team")
+	uint8 TeamByte = 1;
+
+	/** Type of weapon to spawn for the NPC */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Weapon")
+	TSubclassOf<AShooterWeapon> WeaponClass;
+
+	/** Name of the first person mesh weapon socket */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Weapon")
+	FName FirstPersonWeaponSocket = FName("HandGrip_R");
+
+	/** Name of the third person mesh weapon socket */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Weapon")
+	FName ThirdPersonWeaponSocket = FName("HandGrip_R");
+
+	/** Max range for aiming calculations */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Aim", meta = (ClampMin = 0, Units = "cm"))
+	float AimRange = 10000.0f;
+
+	/** Cone variance to apply while aiming */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Aim", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
+	float AimVarianceHalfAngle = 10.0f;
+
+	/** Minimum vertical offset from the target center to apply when aiming */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Aim", meta = (Units = "cm"))
+	float MinAimOffsetZ = -35.0f;
+
+	/** Maximum vertical offset from the target center to apply when aiming */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Aim", meta = (Units = "cm"))
+	float MaxAimOffsetZ = -60.0f;
+
+	/** Seed for the precomputed aim variance. The same seed always produces the same shots */
+	UPROPERTY(EditAnywhere, Category="Aim")
+	int32 AimSeed = 0;
+
+	/** Number of precomputed aim samples. Shots cycle through them in order */
+	static constexpr int32 NumAimSamples = 64;
+
+	/** Precomputed aim directions in the aim frame, with X forward */
+	TArray<FVector> AimDirections;
+
+	/** Precomputed vertical aim offsets, matching AimDirections */
+	TArray<float> AimOffsetsZ;
+
+public:
+
+	/** Builds the aim tables for the class defaults */
+	virtual void PostInitProperties() override;
+
+	/** Builds the aim tables from the loaded tuning */
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	/** Rebuilds the aim tables when the tuning is edited */
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** Returns the aim direction, in the aim frame with X forward, and the vertical aim offset for a shot */
+	void GetAimSample(uint32 ShotIndex, FVector& OutDirection, float& OutOffsetZ) const;
+
+	/** Precomputes the aim variance tables from the seed. Call again after changing the aim tuning at runtime */
+	void BuildAimTables();
+};
@@ -7,7 +7,13 @@
 #include "Components/CapsuleComponent.h"
 #include "Components/ArrowComponent.h"
 #include "TimerManager.h"
+#include "EngineUtils.h"
+#include "Logging/MessageLog.h"
+#include "Misc/UObjectToken.h"
 #include "ShooterNPC.h"
+#include "HellWaveNoiseGraph.h"
+
+#define LOCTEXT_NAMESPACE "ShooterNPCSpawner"
 
 // Sets default values
 AShooterNPCSpawner::AShooterNPCSpawner()
@@ -49,6 +55,27 @@ void AShooterNPCSpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
 	GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
 }
 
+#if WITH_EDITOR
+void AShooterNPCSpawner::CheckForErrors()
+{
+	Super::CheckForErrors();
+
+	// only the first spawner reports, so the level gets one warning
+	TActorIterator<AShooterNPCSpawner> FirstSpawner(GetWorld());
+	if (!FirstSpawner || *FirstSpawner != this)
+	{
+		return;
+	}
+
+	if (!TActorIterator<AHellWaveNoiseGraph>(GetWorld()))
+	{
+		FMessageLog("MapCheck").Warning()
+			->AddToken(FUObjectToken::Create(this))
+			->AddToken(FTextToken::Create(LOCTEXT("MissingNoiseGraph", "Level spawns NPCs but has no HellWaveNoiseGraph. NPCs will hear noises through walls. Place a noise graph and bake it")));
+	}
+}
+#endif // WITH_EDITOR
+
 void AShooterNPCSpawner::SpawnNPC()
 {
 	// ensure the NPC class is valid
@@ -83,3 +110,5 @@ void AShooterNPCSpawner::OnNPCDied()
 	// schedule the next NPC spawn
 	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &AShooterNPCSpawner::SpawnNPC, RespawnDelay);
 }
+
+#undef LOCTEXT_NAMESPACE
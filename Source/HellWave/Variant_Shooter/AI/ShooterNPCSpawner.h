@@ -59,6 +59,11 @@ public:
 	/** Cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+#if WITH_EDITOR
+	/** Warns if the level has no noise graph, so the spawned NPCs would hear noises through walls */
+	virtual void CheckForErrors() override;
+#endif // WITH_EDITOR
+
 protected:
 
 	/** Spawn an NPC and subscribe to its death event */
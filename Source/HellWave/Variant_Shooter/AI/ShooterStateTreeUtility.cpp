@@ -9,6 +9,9 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "ShooterAIController.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "HellWaveArenaDataSubsystem.h"
+#include "HellWaveTeamComponent.h"
+#include "HellWave.h"
 
 bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -49,13 +52,22 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 
 	FHitResult OutHit;
 
+	// the baked visibility grid lets us skip traces that are guaranteed to be blocked
+	UHellWaveArenaDataSubsystem* ArenaData = InstanceData.Character->GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>();
+
 	// run a number of vertically offset line traces to the target location
 	for (int32 i = 0; i < InstanceData.NumberOfVerticalLineOfSightChecks - 1; ++i)
 	{
 		// calculate the endpoint for the trace
 		const FVector End = CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i);
 
-		InstanceData.Character->GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
+		// skip the trace if the bake proved this line is blocked
+		if (ArenaData && !ArenaData->ShouldTraceVisibility(Start, End))
+		{
+			continue;
+		}
+
+		InstanceData.Character->GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_HellWaveAISight, QueryParams);
 
 		// is the trace unobstructed?
 		if (!OutHit.bBlockingHit)
@@ -227,7 +239,10 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 				const FStateTreeStrongExecutionContext StrongContext = WeakContext.MakeStrongExecutionContext();
 				if (FInstanceDataType* LambdaInstanceData = StrongContext.GetInstanceDataPtr<FInstanceDataType>())
 				{
-					if (SensedActor->ActorHasTag(LambdaInstanceData->SenseTag))
+					// only living actors on a team we have the right attitude towards are sensed
+					const UHellWaveTeamComponent* SensedTeam = UHellWaveTeamComponent::FindTeamComponent(SensedActor);
+
+					if (SensedTeam && SensedTeam->IsAlive() && FGenericTeamId::GetAttitude(LambdaInstanceData->Controller->GetGenericTeamId(), SensedTeam->GetTeamId()) == LambdaInstanceData->SenseAttitude)
 					{
 						bool bDirectLOS = false;
 
@@ -238,8 +253,12 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 						const float DirDot = FVector::DotProduct(StimulusDir, LambdaInstanceData->Character->GetActorForwardVector());
 						const float MaxDot = FMath::Cos(FMath::DegreesToRadians(LambdaInstanceData->DirectLineOfSightCone));
 
+						// the baked visibility grid lets us skip traces that are guaranteed to be blocked
+						UHellWaveArenaDataSubsystem* ArenaData = LambdaInstanceData->Character->GetWorld()->GetSubsystem<UHellWaveArenaDataSubsystem>();
+						const bool bCouldSee = !ArenaData || ArenaData->ShouldTraceVisibility(LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation());
+
 						// is the direction within our perception cone?
-						if (DirDot >= MaxDot)
+						if (DirDot >= MaxDot && bCouldSee)
 						{
 							// run a line trace between the character and the sensed actor
 							FCollisionQueryParams QueryParams;
@@ -249,7 +268,7 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 							FHitResult OutHit;
 
 							// we have direct line of sight if this trace is unobstructed
-							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, QueryParams);
+							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_HellWaveAISight, QueryParams);
 
 						}
 
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "StateTreeTaskBase.h"
 #include "StateTreeConditionBase.h"
+#include "GenericTeamAgentInterface.h"
 
 #include "ShooterStateTreeUtility.generated.h"
 
@@ -270,9 +271,9 @@ struct FStateTreeSenseEnemiesInstanceData
 	UPROPERTY(EditAnywhere, Category = Output)
 	bool bHasInvestigateLocation = false;
 
-	/** Tag required on sensed actors */
+	/** Team attitude the NPC must have towards sensed actors */
 	UPROPERTY(EditAnywhere, Category = Parameter)
-	FName SenseTag = FName("Player");
+	TEnumAsByte<ETeamAttitude::Type> SenseAttitude = ETeamAttitude::Hostile;
 
 	/** Line of sight cone half angle to consider a full sense */
 	UPROPERTY(EditAnywhere, Category = Parameter)
@@ -7,11 +7,17 @@
 #include "Components/InputComponent.h"
 #include "Components/PawnNoiseEmitterComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimClassInterface.h"
+#include "Animation/AnimNode_LinkedAnimLayer.h"
 #include "Engine/World.h"
 #include "Camera/CameraComponent.h"
 #include "TimerManager.h"
 #include "ShooterGameMode.h"
+#include "HellWaveTeamComponent.h"
+#include "HellWave.h"
 
 AShooterCharacter::AShooterCharacter()
 {
@@ -29,6 +35,9 @@ void AShooterCharacter::BeginPlay()
 	// reset HP to max
 	CurrentHP = MaxHP;
 
+	// join our team
+	GetTeamComponent()->SetTeamId(FGenericTeamId(TeamByte));
+
 	// update the HUD
 	OnDamaged.Broadcast(1.0f);
 }
@@ -61,8 +70,8 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 
 float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// ignore if already dead
-	if (CurrentHP <= 0.0f)
+	// ignore if already dead or hit by a teammate
+	if (IsDead() || GetTeamComponent()->ShouldIgnoreDamageFrom(EventInstigator ? EventInstigator->GetPawn() : DamageCauser))
 	{
 		return 0.0f;
 	}
@@ -197,19 +206,56 @@ void AShooterCharacter::UpdateWeaponHUD(int32 CurrentAmmo, int32 MagazineSize)
 
 FVector AShooterCharacter::GetWeaponTargetLocation()
 {
+	return GetAimContext().TargetLocation;
+}
+
+FVector AShooterCharacter::GetWeaponMuzzleLocation(const AShooterWeapon* Weapon)
+{
+	// only the equipped weapon's muzzle is cached
+	if (Weapon != CurrentWeapon.Get())
+	{
+		return IShooterWeaponHolder::GetWeaponMuzzleLocation(Weapon);
+	}
+
+	return GetAimContext().MuzzleTransform.GetLocation();
+}
+
+const FShooterAimContext& AShooterCharacter::GetAimContext()
+{
+	// reuse the context if it was already computed this frame
+	if (AimContext.FrameNumber == GFrameCounter)
+	{
+		return AimContext;
+	}
+
+	AimContext.FrameNumber = GFrameCounter;
+
 	// trace ahead from the camera viewpoint
+	const UCameraComponent* Camera = GetFirstPersonCameraComponent();
+
+	AimContext.CameraLocation = Camera->GetComponentLocation();
+	AimContext.CameraDirection = Camera->GetForwardVector();
+
 	FHitResult OutHit;
 
-	const FVector Start = GetFirstPersonCameraComponent()->GetComponentLocation();
-	const FVector End = Start + (GetFirstPersonCameraComponent()->GetForwardVector() * MaxAimDistance);
+	const FVector End = AimContext.CameraLocation + (AimContext.CameraDirection * MaxAimDistance);
 
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
-	GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
+	GetWorld()->LineTraceSingleByChannel(OutHit, AimContext.CameraLocation, End, ECC_HellWaveHitscan, QueryParams);
 
-	// return either the impact point or the trace end
-	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
+	// save either the impact point or the trace end
+	AimContext.bHasTarget = OutHit.bBlockingHit;
+	AimContext.TargetLocation = OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
+	AimContext.TargetActor = OutHit.GetActor();
+
+	// save the equipped weapon's muzzle
+	AimContext.MuzzleTransform = CurrentWeapon
+		? CurrentWeapon->GetFirstPersonMesh()->GetSocketTransform(CurrentWeapon->GetArchetype().MuzzleSocketName)
+		: Camera->GetComponentTransform();
+
+	return AimContext;
 }
 
 void AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass)
@@ -219,14 +265,20 @@ void AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& Weapon
 
 	if (!OwnedWeapon)
 	{
-		// spawn the new weapon
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = this;
-		SpawnParams.Instigator = this;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::MultiplyWithRoot;
+		// adopt a prewarmed weapon if we have one, otherwise spawn the new weapon
+		AShooterWeapon* AddedWeapon = nullptr;
+
+		const int32 ParkedIndex = ParkedWeapons.IndexOfByPredicate([&WeaponClass](const AShooterWeapon* Weapon) { return IsValid(Weapon) && Weapon->IsA(WeaponClass); });
+
+		if (ParkedIndex != INDEX_NONE)
+		{
+			AddedWeapon = ParkedWeapons[ParkedIndex];
+			ParkedWeapons.RemoveAtSwap(ParkedIndex);
 
-		AShooterWeapon* AddedWeapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+		} else {
+
+			AddedWeapon = SpawnWeapon(WeaponClass);
+		}
 
 		if (AddedWeapon)
 		{
@@ -251,9 +303,78 @@ void AShooterCharacter::OnWeaponActivated(AShooterWeapon* Weapon)
 	// update the bullet counter
 	OnBulletCountUpdated.Broadcast(Weapon->GetMagazineSize(), Weapon->GetBulletCount());
 
-	// set the character mesh AnimInstances
-	GetFirstPersonMesh()->SetAnimInstanceClass(Weapon->GetFirstPersonAnimInstanceClass());
-	GetMesh()->SetAnimInstanceClass(Weapon->GetThirdPersonAnimInstanceClass());
+	// the cached muzzle belongs to the previous weapon
+	AimContext.FrameNumber = MAX_uint64;
+
+	// set the character mesh animation for this weapon
+	ApplyWeaponAnimation(GetFirstPersonMesh(), FirstPersonLayerInstances, FirstPersonAnimLayerHostClass, Weapon->GetFirstPersonAnimLayerClass(), Weapon->GetFirstPersonAnimInstanceClass());
+	ApplyWeaponAnimation(GetMesh(), ThirdPersonLayerInstances, ThirdPersonAnimLayerHostClass, Weapon->GetThirdPersonAnimLayerClass(), Weapon->GetThirdPersonAnimInstanceClass());
+}
+
+void AShooterCharacter::ApplyWeaponAnimation(USkeletalMeshComponent* TargetMesh, TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>>& LayerInstances, const TSubclassOf<UAnimInstance>& HostClass, const TSubclassOf<UAnimInstance>& LayerClass, const TSubclassOf<UAnimInstance>& InstanceClass)
+{
+	// without a layer, fall back to swapping the whole anim instance
+	if (!LayerClass || !HostClass)
+	{
+		// the cached layers belong to the host being replaced
+		LayerInstances.Reset();
+		TargetMesh->SetAnimInstanceClass(InstanceClass);
+		return;
+	}
+
+	// the host only needs to be created once. After that a switch just swaps the layer
+	if (TargetMesh->GetAnimClass() != HostClass)
+	{
+		LayerInstances.Reset();
+		TargetMesh->SetAnimInstanceClass(HostClass);
+	}
+
+	LinkWeaponAnimLayer(TargetMesh, LayerInstances, LayerClass);
+}
+
+void AShooterCharacter::LinkWeaponAnimLayer(USkeletalMeshComponent* TargetMesh, TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>>& LayerInstances, const TSubclassOf<UAnimInstance>& LayerClass)
+{
+	UAnimInstance* Host = TargetMesh->GetAnimInstance();
+	if (!Host || !LayerClass)
+	{
+		return;
+	}
+
+	// swap in the instance created the first time this weapon's layer was linked
+	UAnimInstance* LayerInstance = LayerInstances.FindRef(LayerClass);
+	if (IsValid(LayerInstance))
+	{
+		if (Host->GetLinkedAnimLayerInstanceByClass(LayerClass) != LayerInstance)
+		{
+			SetWeaponAnimLayerInstance(Host, LayerClass, LayerInstance);
+		}
+
+		return;
+	}
+
+	// first use of this layer. Let the engine create and initialize the instance, then keep it for later switches
+	TargetMesh->LinkAnimClassLayers(LayerClass);
+	LayerInstances.Add(LayerClass, Host->GetLinkedAnimLayerInstanceByClass(LayerClass));
+}
+
+void AShooterCharacter::SetWeaponAnimLayerInstance(UAnimInstance* Host, const TSubclassOf<UAnimInstance>& LayerClass, UAnimInstance* LayerInstance)
+{
+	const IAnimClassInterface* HostClassInterface = IAnimClassInterface::GetFromClass(Host->GetClass());
+	if (!HostClassInterface)
+	{
+		return;
+	}
+
+	for (const FStructProperty* LayerNodeProperty : HostClassInterface->GetLinkedAnimLayerNodeProperties())
+	{
+		FAnimNode_LinkedAnimLayer* LayerNode = LayerNodeProperty->ContainerPtrToValuePtr<FAnimNode_LinkedAnimLayer>(Host);
+
+		// only the layers this weapon's class implements are swapped
+		if (LayerNode->Interface && LayerClass->ImplementsInterface(LayerNode->Interface))
+		{
+			LayerNode->SetLinkedLayerInstance(Host, LayerInstance);
+		}
+	}
 }
 
 void AShooterCharacter::OnWeaponDeactivated(AShooterWeapon* Weapon)
@@ -282,6 +403,72 @@ AShooterWeapon* AShooterCharacter::FindWeaponOfType(TSubclassOf<AShooterWeapon>
 
 }
 
+AShooterWeapon* AShooterCharacter::SpawnWeapon(const TSubclassOf<AShooterWeapon>& WeaponClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.Instigator = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::MultiplyWithRoot;
+
+	return GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+}
+
+void AShooterCharacter::PrewarmWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass)
+{
+	// skip weapons we already own or have parked
+	if (!WeaponClass || FindWeaponOfType(WeaponClass) || ParkedWeapons.ContainsByPredicate([&WeaponClass](const AShooterWeapon* Weapon) { return IsValid(Weapon) && Weapon->IsA(WeaponClass); }))
+	{
+		return;
+	}
+
+	if (AShooterWeapon* ParkedWeapon = SpawnWeapon(WeaponClass))
+	{
+		// keep it out of sight until it's picked up
+		ParkedWeapon->SetActorHiddenInGame(true);
+		ParkedWeapons.Add(ParkedWeapon);
+
+		// create the layer instances the weapon would otherwise create on its first switch.
+		// Weapons that swap the whole anim instance still build it when they're first equipped
+		const AShooterWeapon* EquippedWeapon = CurrentWeapon.Get();
+
+		PrewarmWeaponAnimLayer(GetFirstPersonMesh(), FirstPersonLayerInstances, FirstPersonAnimLayerHostClass, ParkedWeapon->GetFirstPersonAnimLayerClass(), EquippedWeapon ? EquippedWeapon->GetFirstPersonAnimLayerClass() : nullptr);
+		PrewarmWeaponAnimLayer(GetMesh(), ThirdPersonLayerInstances, ThirdPersonAnimLayerHostClass, ParkedWeapon->GetThirdPersonAnimLayerClass(), EquippedWeapon ? EquippedWeapon->GetThirdPersonAnimLayerClass() : nullptr);
+	}
+}
+
+void AShooterCharacter::PrewarmWeaponAnimLayer(USkeletalMeshComponent* TargetMesh, TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>>& LayerInstances, const TSubclassOf<UAnimInstance>& HostClass, const TSubclassOf<UAnimInstance>& LayerClass, const TSubclassOf<UAnimInstance>& CurrentLayerClass)
+{
+	if (!TargetMesh || !HostClass || !LayerClass || IsValid(LayerInstances.FindRef(LayerClass)))
+	{
+		return;
+	}
+
+	// don't replace the anim instance of an equipped weapon that doesn't use layers
+	if (TargetMesh->GetAnimClass() != HostClass)
+	{
+		if (CurrentWeapon)
+		{
+			return;
+		}
+
+		LayerInstances.Reset();
+		TargetMesh->SetAnimInstanceClass(HostClass);
+	}
+
+	LinkWeaponAnimLayer(TargetMesh, LayerInstances, LayerClass);
+
+	// put back the equipped weapon's layer, or the host's own layers if there isn't one
+	if (CurrentLayerClass)
+	{
+		LinkWeaponAnimLayer(TargetMesh, LayerInstances, CurrentLayerClass);
+
+	} else if (UAnimInstance* Host = TargetMesh->GetAnimInstance()) {
+
+		SetWeaponAnimLayerInstance(Host, LayerClass, nullptr);
+	}
+}
+
 void AShooterCharacter::Die()
 {
 	// deactivate the weapon
@@ -296,8 +483,8 @@ void AShooterCharacter::Die()
 		GM->IncrementTeamScore(TeamByte);
 	}
 
-	// grant the death tag to the character
-	Tags.Add(DeathTag);
+	// raise the dead flag
+	GetTeamComponent()->MarkDead();
 		
 	// stop character movement
 	GetCharacterMovement()->StopMovementImmediately();
@@ -323,6 +510,5 @@ void AShooterCharacter::OnRespawn()
 
 bool AShooterCharacter::IsDead() const
 {
-	// the character is dead if their current HP drops to zero
-	return CurrentHP <= 0.0f;
+	return GetTeamComponent()->IsDead();
 }
@@ -15,6 +15,43 @@ class UPawnNoiseEmitterComponent;
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBulletCountUpdatedDelegate, int32, MagazineSize, int32, Bullets);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDamagedDelegate, float, LifePercent);
 
+/**
+ *  Camera aim trace and weapon muzzle transform for one frame
+ *  Computed on first use in a frame and shared by every shot, pellet, ability and HUD query in it
+ */
+USTRUCT(BlueprintType)
+struct FShooterAimContext
+{
+	GENERATED_BODY()
+
+	/** Camera location the aim trace starts from */
+	UPROPERTY(BlueprintReadOnly, Category="Aim")
+	FVector CameraLocation = FVector::ZeroVector;
+
+	/** Camera facing */
+	UPROPERTY(BlueprintReadOnly, Category="Aim")
+	FVector CameraDirection = FVector::ForwardVector;
+
+	/** Point being aimed at. The aim trace impact point, or the end of the trace */
+	UPROPERTY(BlueprintReadOnly, Category="Aim")
+	FVector TargetLocation = FVector::ZeroVector;
+
+	/** Actor under the crosshair, if any */
+	UPROPERTY(BlueprintReadOnly, Category="Aim")
+	TObjectPtr<AActor> TargetActor;
+
+	/** True if the aim trace hit something */
+	UPROPERTY(BlueprintReadOnly, Category="Aim")
+	bool bHasTarget = false;
+
+	/** World transform of the equipped weapon's muzzle, or the camera if unarmed */
+	UPROPERTY(BlueprintReadOnly, Category="Aim")
+	FTransform MuzzleTransform;
+
+	/** Frame this context was computed on */
+	uint64 FrameNumber = MAX_uint64;
+};
+
 /**
  *  A player controllable first person shooter character
  *  Manages a weapon inventory through the IShooterWeaponHolder interface
@@ -47,6 +84,14 @@ protected:
 	UPROPERTY(EditAnywhere, Category ="Weapons")
 	FName ThirdPersonWeaponSocket = FName("HandGrip_R");
 
+	/** AnimInstance class hosting weapon anim layers on the first person mesh. Stays in place while layers are relinked on weapon switch */
+	UPROPERTY(EditAnywhere, Category ="Weapons")
+	TSubclassOf<UAnimInstance> FirstPersonAnimLayerHostClass;
+
+	/** AnimInstance class hosting weapon anim layers on the third person mesh. Stays in place while layers are relinked on weapon switch */
+	UPROPERTY(EditAnywhere, Category ="Weapons")
+	TSubclassOf<UAnimInstance> ThirdPersonAnimLayerHostClass;
+
 	/** Max distance to use for aim traces */
 	UPROPERTY(EditAnywhere, Category ="Aim", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
 	float MaxAimDistance = 10000.0f;
@@ -62,16 +107,27 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Team")
 	uint8 TeamByte = 0;
 
-	/** Actor tag to grant this character when it dies */
-	UPROPERTY(EditAnywhere, Category="Team")
-	FName DeathTag = FName("Dead");
-
 	/** List of weapons picked up by the character */
 	TArray<AShooterWeapon*> OwnedWeapons;
 
 	/** Weapon currently equipped and ready to shoot with */
 	TObjectPtr<AShooterWeapon> CurrentWeapon;
 
+	/** Weapons spawned ahead of time and kept hidden until picked up */
+	TArray<AShooterWeapon*> ParkedWeapons;
+
+	/** Weapon anim layer instances linked into the first person host, by layer class. Switching back to a weapon swaps its instance back in */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>> FirstPersonLayerInstances;
+
+	/** Weapon anim layer instances linked into the third person host, by layer class. Switching back to a weapon swaps its instance back in */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>> ThirdPersonLayerInstances;
+
+	/** Aim trace and muzzle transform for the current frame */
+	UPROPERTY(Transient)
+	FShooterAimContext AimContext;
+
 	UPROPERTY(EditAnywhere, Category ="Destruction", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float RespawnTime = 5.0f;
 
@@ -151,6 +207,9 @@ public:
 	/** Calculates and returns the aim location for the weapon */
 	virtual FVector GetWeaponTargetLocation() override;
 
+	/** Returns the muzzle location of the weapon, from this frame's aim context when it's the equipped weapon */
+	virtual FVector GetWeaponMuzzleLocation(const AShooterWeapon* Weapon) override;
+
 	/** Gives a weapon of this class to the owner */
 	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) override;
 
@@ -170,6 +229,21 @@ protected:
 	/** Returns true if the character already owns a weapon of the given class */
 	AShooterWeapon* FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const;
 
+	/** Spawns a weapon of the given class owned by this character */
+	AShooterWeapon* SpawnWeapon(const TSubclassOf<AShooterWeapon>& WeaponClass);
+
+	/** Links the anim layer into the mesh's host instance, or swaps the whole anim instance if there's no layer or host */
+	void ApplyWeaponAnimation(USkeletalMeshComponent* TargetMesh, TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>>& LayerInstances, const TSubclassOf<UAnimInstance>& HostClass, const TSubclassOf<UAnimInstance>& LayerClass, const TSubclassOf<UAnimInstance>& InstanceClass);
+
+	/** Swaps in the layer's cached instance, or links the layer class and caches the instance the first time it's used */
+	void LinkWeaponAnimLayer(USkeletalMeshComponent* TargetMesh, TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>>& LayerInstances, const TSubclassOf<UAnimInstance>& LayerClass);
+
+	/** Points every host layer node implemented by the layer class at the given instance */
+	static void SetWeaponAnimLayerInstance(UAnimInstance* Host, const TSubclassOf<UAnimInstance>& LayerClass, UAnimInstance* LayerInstance);
+
+	/** Creates and caches the weapon's layer instance on the real mesh, then restores the equipped weapon's layer */
+	void PrewarmWeaponAnimLayer(USkeletalMeshComponent* TargetMesh, TMap<TSubclassOf<UAnimInstance>, TObjectPtr<UAnimInstance>>& LayerInstances, const TSubclassOf<UAnimInstance>& HostClass, const TSubclassOf<UAnimInstance>& LayerClass, const TSubclassOf<UAnimInstance>& CurrentLayerClass);
+
 	/** Called when this character's HP is depleted */
 	void Die();
 
@@ -184,4 +258,17 @@ public:
 
 	/** Returns true if the character is dead */
 	bool IsDead() const;
+
+	/** Returns this frame's aim context, running the aim trace on first use in the frame */
+	const FShooterAimContext& GetAimContext();
+
+	/** Returns this frame's aim context. Used for crosshair feedback */
+	UFUNCTION(BlueprintPure, Category="Aim", meta = (DisplayName = "Get Aim Context"))
+	FShooterAimContext K2_GetAimContext() { return GetAimContext(); }
+
+	/**
+	 *  Spawns a weapon of this class ahead of time and keeps it hidden, and creates its anim layer instances
+	 *  A later AddWeaponClass for the same class adopts the parked weapon instead of spawning one
+	 */
+	void PrewarmWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass);
 };
@@ -3,8 +3,10 @@
 
 #include "Variant_Shooter/ShooterGameMode.h"
 #include "ShooterUI.h"
+#include "HellWaveDamageSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
+#include "TimerManager.h"
 
 void AShooterGameMode::BeginPlay()
 {
@@ -13,6 +15,12 @@ void AShooterGameMode::BeginPlay()
 	// create the UI
 	ShooterUI = CreateWidget<UShooterUI>(UGameplayStatics::GetPlayerController(GetWorld(), 0), ShooterUIClass);
 	ShooterUI->AddToViewport(0);
+
+	// kills from the end of frame damage pass reach the UI in one update
+	if (UHellWaveDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UHellWaveDamageSubsystem>())
+	{
+		DamageSubsystem->OnDamageResolved.AddUObject(this, &AShooterGameMode::FlushScoreUpdates);
+	}
 }
 
 void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
@@ -28,6 +36,39 @@ void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
 	++Score;
 	TeamScores.Add(TeamByte, Score);
 
-	// update the UI
-	ShooterUI->BP_UpdateScore(TeamByte, Score);
+	// several kills in one frame only update the UI once
+	DirtyTeamScores.Add(TeamByte);
+
+	if (!ScoreUpdateTimer.IsValid())
+	{
+		ScoreUpdateTimer = GetWorldTimerManager().SetTimerForNextTick(this, &AShooterGameMode::FlushScoreUpdates);
+	}
+}
+
+void AShooterGameMode::FlushScoreUpdates()
+{
+	GetWorldTimerManager().ClearTimer(ScoreUpdateTimer);
+
+	for (uint8 TeamByte : DirtyTeamScores)
+	{
+		// update the UI
+		ShooterUI->BP_UpdateScore(TeamByte, TeamScores.FindRef(TeamByte));
+	}
+
+	DirtyTeamScores.Reset();
+}
+
+void AShooterGameMode::ResetTeamScores()
+{
+	// the reset supersedes any pending score update
+	GetWorldTimerManager().ClearTimer(ScoreUpdateTimer);
+	DirtyTeamScores.Reset();
+
+	for (TPair<uint8, int32>& TeamScore : TeamScores)
+	{
+		TeamScore.Value = 0;
+
+		// update the UI
+		ShooterUI->BP_UpdateScore(TeamScore.Key, 0);
+	}
 }
@@ -12,6 +12,7 @@ class UShooterUI;
  *  Simple GameMode for a first person shooter game
  *  Manages game UI
  *  Keeps track of team scores
+ *  Numbers NPCs in spawn order, so per-NPC seeds replay identically between runs
  */
 UCLASS(abstract)
 class HELLWAVE_API AShooterGameMode : public AGameModeBase
@@ -30,6 +31,15 @@ protected:
 	/** Map of scores by team ID */
 	TMap<uint8, int32> TeamScores;
 
+	/** Teams whose score changed since the UI was last updated */
+	TSet<uint8> DirtyTeamScores;
+
+	/** Updates the UI next tick if nothing flushes the scores sooner */
+	FTimerHandle ScoreUpdateTimer;
+
+	/** Spawn index handed to the next NPC */
+	uint32 NextNPCSpawnIndex = 0;
+
 protected:
 
 	/** Gameplay initialization */
@@ -37,6 +47,18 @@ protected:
 
 public:
 
-	/** Increases the score for the given team */
+	/** Increases the score for the given team. The UI is updated on the next score flush */
 	void IncrementTeamScore(uint8 TeamByte);
+
+	/** Pushes every score changed since the last flush to the UI */
+	void FlushScoreUpdates();
+
+	/** Resets every team score to zero */
+	void ResetTeamScores();
+
+	/** Returns the next NPC spawn index. Stable between runs as long as NPCs spawn in the same order */
+	uint32 ClaimNPCSpawnIndex() { return NextNPCSpawnIndex++; }
+
+	/** Restarts NPC spawn numbering, so a restarted run replays the same per-NPC seeds */
+	void ResetNPCSpawnIndex() { NextNPCSpawnIndex = 0; }
 };
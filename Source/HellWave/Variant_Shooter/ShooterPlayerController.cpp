@@ -9,6 +9,7 @@
 #include "GameFramework/PlayerStart.h"
 #include "ShooterCharacter.h"
 #include "ShooterBulletCounterUI.h"
+#include "HellWaveActorRegistrySubsystem.h"
 #include "HellWave.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
@@ -16,6 +17,12 @@ void AShooterPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// keep player starts indexed so respawns don't iterate the world
+	if (UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>())
+	{
+		Registry->TrackClass(APlayerStart::StaticClass());
+	}
+
 	// only spawn touch controls on local player controllers
 	if (IsLocalPlayerController())
 	{
@@ -109,14 +116,23 @@ void AShooterPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 		BulletCounterUI->BP_UpdateBulletCounter(0, 0);
 	}
 
-	// find the player start
-	TArray<AActor*> ActorList;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), ActorList);
+	// find the player starts
+	UHellWaveActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UHellWaveActorRegistrySubsystem>();
+	if (!Registry)
+	{
+		return;
+	}
+
+	const TArray<TWeakObjectPtr<AActor>>& ActorList = Registry->GetActorsOfClass(APlayerStart::StaticClass());
 
 	if (ActorList.Num() > 0)
 	{
 		// select a random player start
-		AActor* RandomPlayerStart = ActorList[FMath::RandRange(0, ActorList.Num() - 1)];
+		AActor* RandomPlayerStart = ActorList[FMath::RandRange(0, ActorList.Num() - 1)].Get();
+		if (!RandomPlayerStart)
+		{
+			return;
+		}
 
 		// spawn a character at the player start
 		const FTransform SpawnTransform = RandomPlayerStart->GetActorTransform();
@@ -9,6 +9,7 @@
 #include "ShooterWeapon.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "Engine/AssetManager.h"
 
 AShooterPickup::AShooterPickup()
 {
@@ -22,10 +23,7 @@ AShooterPickup::AShooterPickup()
 	SphereCollision->SetupAttachment(RootComponent);
 
 	SphereCollision->SetRelativeLocation(FVector(0.0f, 0.0f, 84.0f));
-	SphereCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	SphereCollision->SetCollisionObjectType(ECC_WorldStatic);
-	SphereCollision->SetCollisionResponseToAllChannels(ECR_Ignore);
-	SphereCollision->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	SphereCollision->SetCollisionProfileName(FName("HellWavePickup"));
 	SphereCollision->bFillCollisionUnderneathForNavmesh = true;
 
 	// subscribe to the collision overlap on the sphere
@@ -36,15 +34,22 @@ AShooterPickup::AShooterPickup()
 	Mesh->SetupAttachment(SphereCollision);
 
 	Mesh->SetCollisionProfileName(FName("NoCollision"));
+	Mesh->SetGenerateOverlapEvents(false);
 }
 
 void AShooterPickup::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
+	// game worlds stream the mesh in on BeginPlay instead
+	if (GetWorld() && GetWorld()->IsGameWorld())
+	{
+		return;
+	}
+
 	if (FWeaponTableRow* WeaponData = WeaponType.GetRow<FWeaponTableRow>(FString()))
 	{
-		// set the mesh
+		// set the mesh for the editor preview
 		Mesh->SetStaticMesh(WeaponData->StaticMesh.LoadSynchronous());
 	}
 }
@@ -57,6 +62,36 @@ void AShooterPickup::BeginPlay()
 	{
 		// copy the weapon class
 		WeaponClass = WeaponData->WeaponToSpawn;
+
+		// stream in the weapon class, and the mesh if the level didn't already provide it
+		TArray<FSoftObjectPath> AssetPaths;
+
+		if (!WeaponClass.IsNull())
+		{
+			AssetPaths.Add(WeaponClass.ToSoftObjectPath());
+		}
+
+		if (!Mesh->GetStaticMesh() && !WeaponData->StaticMesh.IsNull())
+		{
+			AssetPaths.Add(WeaponData->StaticMesh.ToSoftObjectPath());
+		}
+
+		if (AssetPaths.Num() > 0)
+		{
+			AssetLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths, FStreamableDelegate::CreateUObject(this, &AShooterPickup::OnAssetsLoaded));
+		}
+	}
+}
+
+void AShooterPickup::OnAssetsLoaded()
+{
+	if (!Mesh->GetStaticMesh())
+	{
+		if (FWeaponTableRow* WeaponData = WeaponType.GetRow<FWeaponTableRow>(FString()))
+		{
+			// set the streamed mesh
+			Mesh->SetStaticMesh(WeaponData->StaticMesh.Get());
+		}
 	}
 }
 
@@ -66,6 +101,13 @@ void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// cancel or release the streamed assets
+	if (AssetLoadHandle.IsValid())
+	{
+		AssetLoadHandle->CancelHandle();
+		AssetLoadHandle.Reset();
+	}
 }
 
 void AShooterPickup::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -73,7 +115,14 @@ void AShooterPickup::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 	// have we collided against a weapon holder?
 	if (IShooterWeaponHolder* WeaponHolder = Cast<IShooterWeaponHolder>(OtherActor))
 	{
-		WeaponHolder->AddWeaponClass(WeaponClass);
+		// the class is normally streamed in by now. If not, load it rather than drop the pickup
+		const TSubclassOf<AShooterWeapon> LoadedWeaponClass = WeaponClass.LoadSynchronous();
+		if (!LoadedWeaponClass)
+		{
+			return;
+		}
+
+		WeaponHolder->AddWeaponClass(LoadedWeaponClass);
 
 		// hide this mesh
 		SetActorHiddenInGame(true);
@@ -106,3 +155,15 @@ void AShooterPickup::FinishRespawn()
 	// enable tick
 	SetActorTickEnabled(true);
 }
+
+void AShooterPickup::ResetPickup()
+{
+	// cancel any pending respawn
+	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// unhide this pickup
+	SetActorHiddenInGame(false);
+
+	// enable collision and tick
+	FinishRespawn();
+}
@@ -6,14 +6,29 @@
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
 #include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
 #include "ShooterPickup.generated.h"
 
 class USphereComponent;
 class UPrimitiveComponent;
 class AShooterWeapon;
+class UDamageType;
+class USoundBase;
 
 /**
- *  Holds information about a type of weapon pickup
+ *  How pellets are laid out in a weapon's spread cone
+ */
+UENUM(BlueprintType)
+enum class EShooterSpreadPattern : uint8
+{
+	SeededRandom	UMETA(ToolTip = "Uniform random directions from a fixed seed"),
+	FixedRing		UMETA(ToolTip = "One center pellet with the rest evenly spaced on a ring"),
+	PoissonDisk		UMETA(ToolTip = "Random directions kept a minimum distance apart, from a fixed seed")
+};
+
+/**
+ *  Holds information about a type of weapon pickup, and the tuning of the weapon it grants
+ *  Tuning is compiled into weapon archetypes by UShooterWeaponArchetypeSubsystem when the game starts
  */
 USTRUCT(BlueprintType)
 struct FWeaponTableRow : public FTableRowBase
@@ -24,9 +39,113 @@ struct FWeaponTableRow : public FTableRowBase
 	UPROPERTY(EditAnywhere)
 	TSoftObjectPtr<UStaticMesh> StaticMesh;
 
-	/** Weapon class to grant on pickup */
+	/** Weapon class to grant on pickup. Leave empty for tuning-only rows, such as NPC weapons */
 	UPROPERTY(EditAnywhere)
-	TSubclassOf<AShooterWeapon> WeaponToSpawn;
+	TSoftClassPtr<AShooterWeapon> WeaponToSpawn;
+
+	/** Number of bullets in a magazine */
+	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 100))
+	int32 MagazineSize = 10;
+
+	/** Maximum reserve ammo capacity */
+	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 500))
+	int32 MaxReserveAmmo = 50;
+
+	/** Reserve ammo the weapon starts with */
+	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 500))
+	int32 StartingReserveAmmo = 50;
+
+	/** If true, the weapon reloads from reserve when the magazine is empty */
+	UPROPERTY(EditAnywhere, Category="Ammo")
+	bool bAutoReloadFromReserve = true;
+
+	/** Time to reload from reserve */
+	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float ReloadTime = 0.5f;
+
+	/** Cone half-angle for variance while aiming */
+	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
+	float AimVariance = 0.0f;
+
+	/** Amount of firing recoil to apply to the owner */
+	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = -100, ClampMax = 100))
+	float FiringRecoil = 0.0f;
+
+	/** Name of the first person muzzle socket where projectiles will spawn */
+	UPROPERTY(EditAnywhere, Category="Aim")
+	FName MuzzleSocketName;
+
+	/** Distance ahead of the muzzle that bullets will spawn at */
+	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float MuzzleOffset = 10.0f;
+
+	/** If true, the weapon will automatically fire at the refire rate */
+	UPROPERTY(EditAnywhere, Category="Refire")
+	bool bFullAuto = false;
+
+	/** Time between shots. Affects both full auto and semi auto modes */
+	UPROPERTY(EditAnywhere, Category="Refire", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float RefireRate = 0.5f;
+
+	/** If true, the weapon fires hitscan traces instead of projectiles */
+	UPROPERTY(EditAnywhere, Category="Hitscan")
+	bool bShouldFireHitscan = true;
+
+	/** Max range of hitscan traces */
+	UPROPERTY(EditAnywhere, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 50000, Units = "cm"))
+	float HitscanRange = 5000.0f;
+
+	/** Damage applied by each hitscan trace */
+	UPROPERTY(EditAnywhere, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 500))
+	float HitscanDamage = 25.0f;
+
+	/** Impulse applied to physics objects by each hitscan trace */
+	UPROPERTY(EditAnywhere, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 50000))
+	float HitscanImpulse = 100.0f;
+
+	/** Damage type applied by hitscan traces */
+	UPROPERTY(EditAnywhere, Category="Hitscan")
+	TSubclassOf<UDamageType> HitscanDamageType;
+
+	/** Number of traces fired per hitscan shot */
+	UPROPERTY(EditAnywhere, Category="Hitscan", meta = (ClampMin = 1, ClampMax = 20))
+	int32 PelletCount = 1;
+
+	/** Half-angle of the pellet spread cone */
+	UPROPERTY(EditAnywhere, Category="Hitscan", meta = (ClampMin = 0, ClampMax = 45, Units = "Degrees"))
+	float SpreadHalfAngle = 0.0f;
+
+	/** Layout of the pellets in the spread cone */
+	UPROPERTY(EditAnywhere, Category="Hitscan")
+	EShooterSpreadPattern SpreadPattern = EShooterSpreadPattern::PoissonDisk;
+
+	/** Number of precomputed spread layouts. Shots cycle through them in order */
+	UPROPERTY(EditAnywhere, Category="Hitscan", meta = (ClampMin = 1, ClampMax = 64))
+	int32 SpreadVariants = 8;
+
+	/** Seed for the random spread patterns. The same seed always produces the same shots */
+	UPROPERTY(EditAnywhere, Category="Hitscan")
+	int32 SpreadSeed = 0;
+
+	/** Loudness of the shot for AI perception system interactions */
+	UPROPERTY(EditAnywhere, Category="Perception", meta = (ClampMin = 0, ClampMax = 100))
+	float ShotLoudness = 1.0f;
+
+	/** Max range of shot AI perception noise */
+	UPROPERTY(EditAnywhere, Category="Perception", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float ShotNoiseRange = 3000.0f;
+
+	/** Tag to apply to noise generated by shooting this weapon */
+	UPROPERTY(EditAnywhere, Category="Perception")
+	FName ShotNoiseTag = FName("Shot");
+
+	/** Sound played for each shot through the audio event layer. Loaded with the weapon */
+	UPROPERTY(EditAnywhere, Category="Audio")
+	TSoftObjectPtr<USoundBase> FireSound;
+
+	/** Layered sound played in place of many simultaneous shots of this weapon. Uses the fire sound if unset */
+	UPROPERTY(EditAnywhere, Category="Audio")
+	TSoftObjectPtr<USoundBase> CrowdFireSound;
 };
 
 /**
@@ -52,7 +171,10 @@ protected:
 	FDataTableRowHandle WeaponType;
 
 	/** Type to weapon to grant on pickup. Set from the weapon data table. */
-	TSubclassOf<AShooterWeapon> WeaponClass;
+	TSoftClassPtr<AShooterWeapon> WeaponClass;
+
+	/** Keeps the pickup's mesh and weapon class resident once streamed in */
+	TSharedPtr<FStreamableHandle> AssetLoadHandle;
 	
 	/** Time to wait before respawning this pickup */
 	UPROPERTY(EditAnywhere, Category="Pickup", meta = (ClampMin = 0, ClampMax = 120, Units = "s"))
@@ -83,6 +205,9 @@ protected:
 
 protected:
 
+	/** Called when the pickup's streamed assets are resident */
+	void OnAssetsLoaded();
+
 	/** Called when it's time to respawn this pickup */
 	void RespawnPickup();
 
@@ -93,4 +218,12 @@ protected:
 	/** Enables this pickup after respawning */
 	UFUNCTION(BlueprintCallable, Category="Pickup")
 	void FinishRespawn();
+
+public:
+
+	/** Immediately returns this pickup to its available state, skipping the respawn delay and animation */
+	void ResetPickup();
+
+	/** Returns the weapon class granted by this pickup. May not be loaded yet */
+	const TSoftClassPtr<AShooterWeapon>& GetWeaponClass() const { return WeaponClass; }
 };
@@ -5,13 +5,17 @@
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "GameFramework/Character.h"
-#include "Kismet/GameplayStatics.h"
 #include "GameFramework/DamageType.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/Controller.h"
 #include "Engine/OverlapResult.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "HellWaveImpulseSubsystem.h"
+#include "HellWaveImpactEffectsSubsystem.h"
+#include "HellWaveNoiseSubsystem.h"
+#include "HellWaveDamageSubsystem.h"
+#include "HellWave.h"
 
 AShooterProjectile::AShooterProjectile()
 {
@@ -23,6 +27,9 @@ AShooterProjectile::AShooterProjectile()
 	CollisionComponent->SetSphereRadius(16.0f);
 	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 	CollisionComponent->SetCollisionResponseToAllChannels(ECR_Block);
+	CollisionComponent->SetCollisionResponseToChannel(ECC_HellWaveHitscan, ECR_Ignore);
+	CollisionComponent->SetCollisionResponseToChannel(ECC_HellWaveAISight, ECR_Ignore);
+	CollisionComponent->SetGenerateOverlapEvents(false);
 	CollisionComponent->CanCharacterStepUpOn = ECanBeCharacterBase::ECB_No;
 
 	// create the projectile movement component. No need to attach it because it's not a Scene Component
@@ -65,8 +72,11 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 	// disable collision on the projectile
 	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
-	// make AI perception noise
-	MakeNoise(NoiseLoudness, GetInstigator(), GetActorLocation(), NoiseRange, NoiseTag);
+	// make AI perception noise. The noise aggregator merges impacts from the same instigator
+	if (UHellWaveNoiseSubsystem* Noises = GetWorld()->GetSubsystem<UHellWaveNoiseSubsystem>())
+	{
+		Noises->ReportNoise(NoiseLoudness, GetInstigator(), GetActorLocation(), NoiseRange, NoiseTag);
+	}
 
 	if (bExplodeOnHit)
 	{
@@ -81,6 +91,12 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 
 	}
 
+	// queue the pooled impact effects
+	if (UHellWaveImpactEffectsSubsystem* ImpactEffects = GetWorld()->GetSubsystem<UHellWaveImpactEffectsSubsystem>())
+	{
+		ImpactEffects->RequestImpact(Hit);
+	}
+
 	// pass control to BP for any extra effects
 	BP_OnProjectileHit(Hit);
 
@@ -147,16 +163,19 @@ void AShooterProjectile::ProcessHit(AActor* HitActor, UPrimitiveComponent* HitCo
 		// ignore the owner of this projectile
 		if (HitCharacter != GetOwner() || bDamageOwner)
 		{
-			// apply damage to the character
-			UGameplayStatics::ApplyDamage(HitCharacter, HitDamage, GetInstigator()->GetController(), this, HitDamageType);
+			// queue damage to the character. Explosion hits are summed and resolved once per frame
+			if (UHellWaveDamageSubsystem* Damage = GetWorld()->GetSubsystem<UHellWaveDamageSubsystem>())
+			{
+				Damage->QueueDamage(HitCharacter, HitDamage, GetInstigatorController(), this, HitDamageType);
+			}
 		}
 	}
 
-	// have we hit a physics object?
-	if (HitComp->IsSimulatingPhysics())
+	// give some physics impulse to the object. Impulses are summed and applied once per frame,
+	// after damage resolves, to whatever is simulating physics by then
+	if (UHellWaveImpulseSubsystem* Impulses = GetWorld()->GetSubsystem<UHellWaveImpulseSubsystem>())
 	{
-		// give some physics impulse to the object
-		HitComp->AddImpulseAtLocation(HitDirection * PhysicsForce, HitLocation);
+		Impulses->AddImpulseAtLocation(HitComp, HitDirection * PhysicsForce, HitLocation);
 	}
 }
 
@@ -11,11 +11,22 @@
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Pawn.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "ShooterWeaponArchetypeSubsystem.h"
+#include "ShooterPickup.h"
+#include "HellWaveAudioEventSubsystem.h"
+#include "HellWaveNoiseSubsystem.h"
+#include "Sound/SoundBase.h"
+#include "HellWave.h"
 
 AShooterWeapon::AShooterWeapon()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	// only full auto weapons tick, and only while firing
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
 	// create the root
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 
@@ -24,6 +35,7 @@ AShooterWeapon::AShooterWeapon()
 	FirstPersonMesh->SetupAttachment(RootComponent);
 
 	FirstPersonMesh->SetCollisionProfileName(FName("NoCollision"));
+	FirstPersonMesh->SetGenerateOverlapEvents(false);
 	FirstPersonMesh->SetFirstPersonPrimitiveType(EFirstPersonPrimitiveType::FirstPerson);
 	FirstPersonMesh->bOnlyOwnerSee = true;
 
@@ -32,6 +44,7 @@ AShooterWeapon::AShooterWeapon()
 	ThirdPersonMesh->SetupAttachment(RootComponent);
 
 	ThirdPersonMesh->SetCollisionProfileName(FName("NoCollision"));
+	ThirdPersonMesh->SetGenerateOverlapEvents(false);
 	ThirdPersonMesh->SetFirstPersonPrimitiveType(EFirstPersonPrimitiveType::WorldSpaceRepresentation);
 	ThirdPersonMesh->bOwnerNoSee = true;
 }
@@ -47,11 +60,56 @@ void AShooterWeapon::BeginPlay()
 	WeaponOwner = Cast<IShooterWeaponHolder>(GetOwner());
 	PawnOwner = Cast<APawn>(GetOwner());
 
+	// look up our tuning before anything reads it
+	ResolveArchetype();
+
 	// fill the first ammo clip
-	CurrentBullets = MagazineSize;
+	CurrentBullets = Archetype->MagazineSize;
 
 	// attach the meshes to the owner
 	WeaponOwner->AttachWeaponMeshes(this);
+
+	// the weapon is spawned on pickup, so stream in the projectile, montage, anim classes and sounds now
+	TArray<FSoftObjectPath> AssetPaths;
+	GetSoftAssetPaths(AssetPaths, *Archetype);
+
+	if (AssetPaths.Num() > 0)
+	{
+		AssetLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths, FStreamableDelegate::CreateUObject(this, &AShooterWeapon::OnAssetsLoaded));
+
+		// prewarmed assets are already resident, so don't wait for the callback
+		if (AssetLoadHandle.IsValid() && AssetLoadHandle->HasLoadCompleted())
+		{
+			OnAssetsLoaded();
+		}
+
+	} else {
+
+		OnAssetsLoaded();
+	}
+}
+
+void AShooterWeapon::OnAssetsLoaded()
+{
+	if (bAssetsLoaded)
+	{
+		return;
+	}
+
+	bAssetsLoaded = true;
+
+	// finish an activation that was waiting on the anim classes
+	if (bActivationPending)
+	{
+		bActivationPending = false;
+		WeaponOwner->OnWeaponActivated(this);
+	}
+
+	// start firing if the trigger was pulled while we were streaming in
+	if (bIsFiring)
+	{
+		StartFiring();
+	}
 }
 
 void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -60,8 +118,103 @@ void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the refire timer
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
+
+	// let go of the streamed assets
+	if (AssetLoadHandle.IsValid())
+	{
+		AssetLoadHandle->ReleaseHandle();
+		AssetLoadHandle.Reset();
+	}
+}
+
+void AShooterWeapon::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bIsFiring || !Archetype->bFullAuto)
+	{
+		return;
+	}
+
+	// count the shots that came due since last frame
+	RefireAccumulator += DeltaTime;
+	AimSampleAge += DeltaTime;
+
+	const int32 NumShots = FMath::FloorToInt(RefireAccumulator / FMath::Max(Archetype->RefireRate, UE_KINDA_SMALL_NUMBER));
+
+	if (NumShots > 0)
+	{
+		RefireAccumulator -= NumShots * Archetype->RefireRate;
+
+		FireBatch(NumShots);
+	}
 }
 
+void AShooterWeapon::ResolveArchetype()
+{
+	int32 ArchetypeIndex = INDEX_NONE;
+	Archetype = &FindArchetype(GetGameInstance(), &ArchetypeIndex);
+
+	if (ArchetypeIndex == INDEX_NONE)
+	{
+#if WITH_EDITOR
+		UE_LOG(LogHellWave, Warning, TEXT("%s has no weapon archetype row. Using its deprecated tuning properties until it's added to the weapon data table."), *GetClass()->GetName());
+#else
+		UE_LOG(LogHellWave, Warning, TEXT("%s has no weapon archetype row and no row was baked for it on cook. Using default tuning."), *GetClass()->GetName());
+#endif
+	}
+}
+
+const FShooterWeaponArchetype& AShooterWeapon::FindArchetype(const UGameInstance* GameInstance, int32* OutIndex) const
+{
+	UShooterWeaponArchetypeSubsystem* Archetypes = GameInstance ? GameInstance->GetSubsystem<UShooterWeaponArchetypeSubsystem>() : nullptr;
+
+	int32 Index = INDEX_NONE;
+
+	if (Archetypes)
+	{
+		// an explicit row wins over the row that grants our class
+		Index = ArchetypeRow.IsNone() ? Archetypes->FindArchetypeIndex(GetClass()) : Archetypes->FindArchetypeIndex(ArchetypeRow);
+	}
+
+	if (OutIndex)
+	{
+		*OutIndex = Index;
+	}
+
+	if (!Archetypes)
+	{
+		return FShooterWeaponArchetype::Default;
+	}
+
+#if WITH_EDITOR
+	// weapons that haven't been moved to the data table keep the tuning set on their Blueprint.
+	// cooked builds get a row baked for them instead
+	if (Index == INDEX_NONE)
+	{
+		return Archetypes->FindOrAddFallbackArchetype(GetClass()->GetDefaultObject<AShooterWeapon>());
+	}
+#endif // WITH_EDITOR
+
+	return Archetypes->GetArchetype(Index);
+}
+
+#if WITH_EDITOR
+void AShooterWeapon::GetFallbackTuning(FWeaponTableRow& OutRow) const
+{
+	OutRow.MagazineSize = MagazineSize;
+	OutRow.AimVariance = AimVariance;
+	OutRow.FiringRecoil = FiringRecoil;
+	OutRow.MuzzleSocketName = MuzzleSocketName;
+	OutRow.MuzzleOffset = MuzzleOffset;
+	OutRow.bFullAuto = bFullAuto;
+	OutRow.RefireRate = RefireRate;
+	OutRow.ShotLoudness = ShotLoudness;
+	OutRow.ShotNoiseRange = ShotNoiseRange;
+	OutRow.ShotNoiseTag = ShotNoiseTag;
+}
+#endif // WITH_EDITOR
+
 void AShooterWeapon::OnOwnerDestroyed(AActor* DestroyedActor)
 {
 	// ensure this weapon is destroyed when the owner is destroyed
@@ -73,6 +226,13 @@ void AShooterWeapon::ActivateWeapon()
 	// unhide this weapon
 	SetActorHiddenInGame(false);
 
+	// the owner needs our anim classes, so hold the notification until they've streamed in
+	if (!bAssetsLoaded)
+	{
+		bActivationPending = true;
+		return;
+	}
+
 	// notify the owner
 	WeaponOwner->OnWeaponActivated(this);
 }
@@ -85,12 +245,23 @@ void AShooterWeapon::DeactivateWeapon()
 	// hide the weapon
 	SetActorHiddenInGame(true);
 
+	// a weapon switched away from before it streamed in doesn't need to be shown any more
+	bActivationPending = false;
+
 	// notify the owner
 	WeaponOwner->OnWeaponDeactivated(this);
 }
 
 void AShooterWeapon::StartFiring()
 {
+	// can't fire until the projectile and montage have streamed in.
+	// hold the trigger so the weapon starts firing as soon as they arrive
+	if (!bAssetsLoaded)
+	{
+		bIsFiring = true;
+		return;
+	}
+
 	// raise the firing flag
 	bIsFiring = true;
 
@@ -98,20 +269,25 @@ void AShooterWeapon::StartFiring()
 	// this may be under the refire rate if the weapon shoots slow enough and the player is spamming the trigger
 	const float TimeSinceLastShot = GetWorld()->GetTimeSeconds() - TimeOfLastShot;
 
-	if (TimeSinceLastShot > RefireRate)
+	if (TimeSinceLastShot > Archetype->RefireRate)
 	{
 		// fire the weapon right away
+		RefireAccumulator = 0.0f;
 		Fire();
 
 	} else {
 
-		// if we're full auto, schedule the next shot
-		if (bFullAuto)
-		{
-			GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, TimeSinceLastShot, false);
-		}
+		// if we're full auto, carry the time already waited so the next shot comes due on schedule
+		RefireAccumulator = TimeSinceLastShot;
+		AimSampleAge = TimeSinceLastShot;
 
 	}
+
+	// full auto shots are fired from Tick as they come due
+	if (Archetype->bFullAuto && bIsFiring)
+	{
+		SetActorTickEnabled(true);
+	}
 }
 
 void AShooterWeapon::StopFiring()
@@ -121,6 +297,9 @@ void AShooterWeapon::StopFiring()
 
 	// clear the refire timer
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
+
+	// stop the full auto scheduler
+	SetActorTickEnabled(false);
 }
 
 void AShooterWeapon::Fire()
@@ -130,29 +309,114 @@ void AShooterWeapon::Fire()
 	{
 		return;
 	}
-	
+
+	const FVector TargetLocation = WeaponOwner->GetWeaponTargetLocation();
+
 	// fire a projectile at the target
-	FireProjectile(WeaponOwner->GetWeaponTargetLocation());
+	FireProjectile(TargetLocation);
+
+	PlayFireSound(1);
+
+	// save the aim so the next full auto batch can interpolate from it
+	RecordAimSample(TargetLocation, WeaponOwner->GetWeaponMuzzleLocation(this));
 
 	// update the time of our last shot
 	TimeOfLastShot = GetWorld()->GetTimeSeconds();
 
 	// make noise so the AI perception system can hear us
-	MakeNoise(ShotLoudness, PawnOwner, PawnOwner->GetActorLocation(), ShotNoiseRange, ShotNoiseTag);
+	ReportShotNoise(Archetype->ShotLoudness, Archetype->ShotNoiseRange, Archetype->ShotNoiseTag);
 
-	// are we full auto?
-	if (bFullAuto)
+	// semi-auto weapons schedule the cooldown notification. Full auto refire is handled by Tick
+	if (!Archetype->bFullAuto)
 	{
-		// schedule the next shot
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, RefireRate, false);
-	} else {
+		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::FireCooldownExpired, Archetype->RefireRate, false);
+	}
+}
 
-		// for semi-auto weapons, schedule the cooldown notification
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::FireCooldownExpired, RefireRate, false);
+void AShooterWeapon::FireBatch(int32 NumShots)
+{
+	// ensure the player still wants to fire
+	if (!bIsFiring)
+	{
+		return;
+	}
+
+	// sample the aim once for the whole batch
+	const FVector TargetLocation = WeaponOwner->GetWeaponTargetLocation();
+	const FVector MuzzleLocation = WeaponOwner->GetWeaponMuzzleLocation(this);
+
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+	{
+		// place each shot between the last aim sample and this one
+		const float Alpha = GetBatchShotAlpha(ShotIndex, NumShots);
 
+		SpawnProjectile(CalculateProjectileSpawnTransform(FMath::Lerp(LastMuzzleLocation, MuzzleLocation, Alpha), FMath::Lerp(LastAimTarget, TargetLocation, Alpha)));
+
+		// consume bullets, reloading the clip when depleted
+		if (--CurrentBullets <= 0)
+		{
+			CurrentBullets = Archetype->MagazineSize;
+		}
+	}
+
+	// play the firing montage, sound and recoil once for the batch
+	WeaponOwner->PlayFiringMontage(GetFiringMontage());
+	PlayFireSound(NumShots);
+	WeaponOwner->AddWeaponRecoil(Archetype->FiringRecoil * NumShots);
+
+	// update the weapon HUD once
+	WeaponOwner->UpdateWeaponHUD(CurrentBullets, Archetype->MagazineSize);
+
+	RecordAimSample(TargetLocation, MuzzleLocation);
+
+	// update the time of our last shot
+	TimeOfLastShot = GetWorld()->GetTimeSeconds();
+
+	// make noise so the AI perception system can hear us
+	ReportShotNoise(Archetype->ShotLoudness, Archetype->ShotNoiseRange, Archetype->ShotNoiseTag);
+}
+
+void AShooterWeapon::PlayFireSound(int32 NumShots)
+{
+	// the audio event layer collapses simultaneous shots into crowd gunfire
+	if (USoundBase* FireSound = Archetype->FireSound.Get())
+	{
+		if (UHellWaveAudioEventSubsystem* AudioEvents = GetWorld()->GetSubsystem<UHellWaveAudioEventSubsystem>())
+		{
+			AudioEvents->PostSoundEvent(FireSound, Archetype->CrowdFireSound.Get(), GetActorLocation(), NumShots);
+		}
+	}
+}
+
+void AShooterWeapon::ReportShotNoise(float Loudness, float MaxRange, FName Tag)
+{
+	// the noise aggregator merges shots from the same pawn before perception hears them
+	if (UHellWaveNoiseSubsystem* Noises = GetWorld()->GetSubsystem<UHellWaveNoiseSubsystem>())
+	{
+		Noises->ReportNoise(Loudness, PawnOwner, PawnOwner->GetActorLocation(), MaxRange, Tag);
 	}
 }
 
+float AShooterWeapon::GetBatchShotAlpha(int32 ShotIndex, int32 NumShots) const
+{
+	if (AimSampleAge <= UE_KINDA_SMALL_NUMBER)
+	{
+		return 1.0f;
+	}
+
+	// the last shot of the batch came due RefireAccumulator seconds ago, and each earlier one a refire interval before that
+	const float ShotAge = RefireAccumulator + (NumShots - 1 - ShotIndex) * Archetype->RefireRate;
+
+	return FMath::Clamp(1.0f - (ShotAge / AimSampleAge), 0.0f, 1.0f);
+}
+
+void AShooterWeapon::RecordAimSample(const FVector& AimTarget, const FVector& MuzzleLocation)
+{
+	LastAimTarget = AimTarget;
+	LastMuzzleLocation = MuzzleLocation;
+	AimSampleAge = 0.0f;
+}
+
 void AShooterWeapon::FireCooldownExpired()
 {
 	// notify the owner
@@ -161,23 +425,14 @@ void AShooterWeapon::FireCooldownExpired()
 
 void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 {
-	// get the projectile transform
-	FTransform ProjectileTransform = CalculateProjectileSpawnTransform(TargetLocation);
-	
 	// spawn the projectile
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
-	SpawnParams.Owner = GetOwner();
-	SpawnParams.Instigator = PawnOwner;
-
-	AShooterProjectile* Projectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	SpawnProjectile(CalculateProjectileSpawnTransform(TargetLocation));
 
 	// play the firing montage
-	WeaponOwner->PlayFiringMontage(FiringMontage);
+	WeaponOwner->PlayFiringMontage(GetFiringMontage());
 
 	// add recoil
-	WeaponOwner->AddWeaponRecoil(FiringRecoil);
+	WeaponOwner->AddWeaponRecoil(Archetype->FiringRecoil);
 
 	// consume bullets
 	--CurrentBullets;
@@ -185,34 +440,83 @@ void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 	// if the clip is depleted, reload it
 	if (CurrentBullets <= 0)
 	{
-		CurrentBullets = MagazineSize;
+		CurrentBullets = Archetype->MagazineSize;
 	}
 
 	// update the weapon HUD
-	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
+	WeaponOwner->UpdateWeaponHUD(CurrentBullets, Archetype->MagazineSize);
 }
 
 FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector& TargetLocation) const
 {
 	// find the muzzle location
-	const FVector MuzzleLoc = FirstPersonMesh->GetSocketLocation(MuzzleSocketName);
+	return CalculateProjectileSpawnTransform(WeaponOwner->GetWeaponMuzzleLocation(this), TargetLocation);
+}
 
+FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector& MuzzleLoc, const FVector& TargetLocation) const
+{
 	// calculate the spawn location ahead of the muzzle
-	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * MuzzleOffset);
+	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * Archetype->MuzzleOffset);
 
 	// find the aim rotation vector while applying some variance to the target 
-	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (UKismetMathLibrary::RandomUnitVector() * AimVariance));
+	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (UKismetMathLibrary::RandomUnitVector() * Archetype->AimVariance));
 
 	// return the built transform
 	return FTransform(AimRot, SpawnLoc, FVector::OneVector);
 }
 
-const TSubclassOf<UAnimInstance>& AShooterWeapon::GetFirstPersonAnimInstanceClass() const
+void AShooterWeapon::SpawnProjectile(const FTransform& ProjectileTransform)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
+	SpawnParams.Owner = GetOwner();
+	SpawnParams.Instigator = PawnOwner;
+
+	if (const TSubclassOf<AShooterProjectile> LoadedProjectileClass = GetProjectileClass())
+	{
+		GetWorld()->SpawnActor<AShooterProjectile>(LoadedProjectileClass, ProjectileTransform, SpawnParams);
+	}
+}
+
+TSubclassOf<AShooterProjectile> AShooterWeapon::GetProjectileClass() const
+{
+	return ProjectileClass.Get();
+}
+
+UAnimMontage* AShooterWeapon::GetFiringMontage() const
 {
-	return FirstPersonAnimInstanceClass;
+	return FiringMontage.Get();
 }
 
-const TSubclassOf<UAnimInstance>& AShooterWeapon::GetThirdPersonAnimInstanceClass() const
+TSubclassOf<UAnimInstance> AShooterWeapon::GetFirstPersonAnimInstanceClass() const
 {
-	return ThirdPersonAnimInstanceClass;
+	return FirstPersonAnimInstanceClass.Get();
+}
+
+TSubclassOf<UAnimInstance> AShooterWeapon::GetThirdPersonAnimInstanceClass() const
+{
+	return ThirdPersonAnimInstanceClass.Get();
+}
+
+void AShooterWeapon::GetSoftAssetPaths(TArray<FSoftObjectPath>& OutPaths, const FShooterWeaponArchetype& WeaponArchetype) const
+{
+	const FSoftObjectPath Paths[] = {
+		ProjectileClass.ToSoftObjectPath(),
+		FiringMontage.ToSoftObjectPath(),
+		FirstPersonAnimInstanceClass.ToSoftObjectPath(),
+		ThirdPersonAnimInstanceClass.ToSoftObjectPath(),
+		FirstPersonAnimLayerClass.ToSoftObjectPath(),
+		ThirdPersonAnimLayerClass.ToSoftObjectPath(),
+		WeaponArchetype.FireSound.ToSoftObjectPath(),
+		WeaponArchetype.CrowdFireSound.ToSoftObjectPath()
+	};
+
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (!Path.IsNull())
+		{
+			OutPaths.AddUnique(Path);
+		}
+	}
 }
@@ -6,6 +6,8 @@
 #include "GameFramework/Actor.h"
 #include "ShooterWeaponHolder.h"
 #include "Animation/AnimInstance.h"
+#include "Engine/StreamableManager.h"
+#include "ShooterWeaponArchetype.h"
 #include "ShooterWeapon.generated.h"
 
 class IShooterWeaponHolder;
@@ -13,11 +15,14 @@ class AShooterProjectile;
 class USkeletalMeshComponent;
 class UAnimMontage;
 class UAnimInstance;
+class UGameInstance;
+struct FWeaponTableRow;
 
 /**
  *  Base class for a simple first person shooter weapon
  *  Provides both first person and third person perspective meshes
  *  Handles ammo and firing logic
+ *  Tuning is read from a compiled weapon archetype, so instances only carry their mutable state
  *  Interacts with the weapon owner through the ShooterWeaponHolder interface
  */
 UCLASS(abstract)
@@ -38,76 +43,116 @@ protected:
 	/** Cast pointer to the weapon owner */
 	IShooterWeaponHolder* WeaponOwner;
 
-	/** Type of projectiles this weapon will shoot */
-	UPROPERTY(EditAnywhere, Category="Ammo")
-	TSubclassOf<AShooterProjectile> ProjectileClass;
+	/** Weapon data table row with this weapon's tuning. If unset, the row that grants this weapon class is used */
+	UPROPERTY(EditDefaultsOnly, Category="Archetype")
+	FName ArchetypeRow;
 
-	/** Number of bullets in a magazine */
-	UPROPERTY(EditAnywhere, Category="Ammo", meta = (ClampMin = 0, ClampMax = 100))
-	int32 MagazineSize = 10;
+	/** Compiled tuning for this weapon, shared with every weapon of the same archetype */
+	const FShooterWeaponArchetype* Archetype = &FShooterWeaponArchetype::Default;
 
-	/** Number of bullets in the current magazine */
-	int32 CurrentBullets = 0;
-	
-	/** Animation montage to play when firing this weapon */
-	UPROPERTY(EditAnywhere, Category="Animation")
-	UAnimMontage* FiringMontage;
-
-	/** AnimInstance class to set for the first person character mesh when this weapon is active */
-	UPROPERTY(EditAnywhere, Category="Animation")
-	TSubclassOf<UAnimInstance> FirstPersonAnimInstanceClass;
+#if WITH_EDITORONLY_DATA
+	// Deprecated tuning, editor only. Weapons without a data table row get a row baked from these when the table is cooked
 
-	/** AnimInstance class to set for the third person character mesh when this weapon is active */
-	UPROPERTY(EditAnywhere, Category="Animation")
-	TSubclassOf<UAnimInstance> ThirdPersonAnimInstanceClass;
+	/** Number of bullets in a magazine. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Ammo", meta = (ClampMin = 0, ClampMax = 100))
+	int32 MagazineSize = 10;
 
-	/** Cone half-angle for variance while aiming */
-	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
+	/** Cone half-angle for variance while aiming. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Aim", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
 	float AimVariance = 0.0f;
 
-	/** Amount of firing recoil to apply to the owner */
-	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, ClampMax = 100))
+	/** Amount of firing recoil to apply to the owner. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Aim", meta = (ClampMin = -100, ClampMax = 100))
 	float FiringRecoil = 0.0f;
 
-	/** Name of the first person muzzle socket where projectiles will spawn */
-	UPROPERTY(EditAnywhere, Category="Aim")
+	/** Name of the first person muzzle socket where projectiles will spawn. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Aim")
 	FName MuzzleSocketName;
 
-	/** Distance ahead of the muzzle that bullets will spawn at */
-	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	/** Distance ahead of the muzzle that bullets will spawn at. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Aim", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
 	float MuzzleOffset = 10.0f;
 
-	/** If true, this weapon will automatically fire at the refire rate */
-	UPROPERTY(EditAnywhere, Category="Refire")
+	/** If true, this weapon will automatically fire at the refire rate. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Refire")
 	bool bFullAuto = false;
 
-	/** Time between shots for this weapon. Affects both full auto and semi auto modes */
-	UPROPERTY(EditAnywhere, Category="Refire", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	/** Time between shots for this weapon. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Refire", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float RefireRate = 0.5f;
 
+	/** Loudness of the shot for AI perception system interactions. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Perception", meta = (ClampMin = 0, ClampMax = 100))
+	float ShotLoudness = 1.0f;
+
+	/** Max range of shot AI perception noise. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Perception", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float ShotNoiseRange = 3000.0f;
+
+	/** Tag to apply to noise generated by shooting this weapon. Fallback for weapons without an archetype row */
+	UPROPERTY(EditDefaultsOnly, Category="Perception")
+	FName ShotNoiseTag = FName("Shot");
+#endif // WITH_EDITORONLY_DATA
+
+	/** Type of projectiles this weapon will shoot. Streamed in when the weapon is picked up */
+	UPROPERTY(EditAnywhere, Category="Ammo")
+	TSoftClassPtr<AShooterProjectile> ProjectileClass;
+
+	/** Number of bullets in the current magazine */
+	int32 CurrentBullets = 0;
+	
+	/** Animation montage to play when firing this weapon. Streamed in when the weapon is picked up */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSoftObjectPtr<UAnimMontage> FiringMontage;
+
+	/** AnimInstance class to set for the first person character mesh when this weapon is active */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSoftClassPtr<UAnimInstance> FirstPersonAnimInstanceClass;
+
+	/** AnimInstance class to set for the third person character mesh when this weapon is active */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSoftClassPtr<UAnimInstance> ThirdPersonAnimInstanceClass;
+
+	/** Anim layer class linked into the first person character mesh when this weapon is active. Takes priority over the AnimInstance class */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSoftClassPtr<UAnimInstance> FirstPersonAnimLayerClass;
+
+	/** Anim layer class linked into the third person character mesh when this weapon is active. Takes priority over the AnimInstance class */
+	UPROPERTY(EditAnywhere, Category="Animation")
+	TSoftClassPtr<UAnimInstance> ThirdPersonAnimLayerClass;
+
 	/** Game time of last shot fired, used to enforce refire rate on semi auto */
 	float TimeOfLastShot = 0.0f;
 
 	/** If true, the weapon is currently firing */
 	bool bIsFiring = false;
 
-	/** Timer to handle full auto refiring */
+	/** Timer to handle semi auto refire cooldown */
 	FTimerHandle RefireTimer;
 
-	/** Cast pawn pointer to the owner for AI perception system interactions */
-	TObjectPtr<APawn> PawnOwner;
+	/** Full auto fire time not yet spent on a shot. Carried across frames so the fire rate doesn't depend on the framerate */
+	float RefireAccumulator = 0.0f;
 
-	/** Loudness of the shot for AI perception system interactions */
-	UPROPERTY(EditAnywhere, Category="Perception", meta = (ClampMin = 0, ClampMax = 100))
-	float ShotLoudness = 1.0f;
+	/** Time since the aim was last sampled. Used to place batched shots between the last aim and the current one */
+	float AimSampleAge = 0.0f;
 
-	/** Max range of shot AI perception noise */
-	UPROPERTY(EditAnywhere, Category="Perception", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
-	float ShotNoiseRange = 3000.0f;
+	/** Aim target sampled by the last shot or batch */
+	FVector LastAimTarget = FVector::ZeroVector;
 
-	/** Tag to apply to noise generated by shooting this weapon */
-	UPROPERTY(EditAnywhere, Category="Perception")
-	FName ShotNoiseTag = FName("Shot");
+	/** Muzzle location sampled by the last shot or batch */
+	FVector LastMuzzleLocation = FVector::ZeroVector;
+
+	/** Keeps the weapon's soft referenced assets resident while it's in play */
+	TSharedPtr<FStreamableHandle> AssetLoadHandle;
+
+	/** True once the soft referenced assets have streamed in. The weapon can't fire or be shown on the owner until then */
+	bool bAssetsLoaded = false;
+
+	/** True if the weapon was activated before its assets streamed in. The owner is notified once they arrive */
+	bool bActivationPending = false;
+
+	/** Cast pawn pointer to the owner for AI perception system interactions */
+	TObjectPtr<APawn> PawnOwner;
 
 public:	
 
@@ -122,8 +167,17 @@ protected:
 	/** Gameplay Cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Fires the full auto shots that came due this frame */
+	virtual void Tick(float DeltaTime) override;
+
 protected:
 
+	/** Looks up the compiled archetype for this weapon */
+	void ResolveArchetype();
+
+	/** Called when the soft referenced assets have streamed in */
+	void OnAssetsLoaded();
+
 	/** Called when the weapon's owner is destroyed */
 	UFUNCTION()
 	void OnOwnerDestroyed(AActor* DestroyedActor);
@@ -147,6 +201,21 @@ protected:
 	/** Fire the weapon */
 	virtual void Fire();
 
+	/** Fires several full auto shots as one batch, with a single HUD update */
+	virtual void FireBatch(int32 NumShots);
+
+	/** Posts the fire sound for a number of shots to the audio event layer */
+	void PlayFireSound(int32 NumShots);
+
+	/** Reports a shot noise for AI hearing through the noise aggregator */
+	void ReportShotNoise(float Loudness, float MaxRange, FName Tag);
+
+	/** Returns where a shot in the current batch falls between the last aim sample (0) and now (1) */
+	float GetBatchShotAlpha(int32 ShotIndex, int32 NumShots) const;
+
+	/** Saves the aim and muzzle location as the start point for the next batch */
+	void RecordAimSample(const FVector& AimTarget, const FVector& MuzzleLocation);
+
 	/** Called when the refire rate time has passed while shooting semi auto weapons */
 	void FireCooldownExpired();
 
@@ -156,6 +225,18 @@ protected:
 	/** Calculates the spawn transform for projectiles shot by this weapon */
 	FTransform CalculateProjectileSpawnTransform(const FVector& TargetLocation) const;
 
+	/** Calculates the spawn transform for projectiles shot from the given muzzle location */
+	FTransform CalculateProjectileSpawnTransform(const FVector& MuzzleLocation, const FVector& TargetLocation) const;
+
+	/** Spawns a projectile with the given transform */
+	void SpawnProjectile(const FTransform& ProjectileTransform);
+
+	/** Returns the projectile class, or nullptr if it hasn't streamed in yet */
+	TSubclassOf<AShooterProjectile> GetProjectileClass() const;
+
+	/** Returns the firing montage, or nullptr if it hasn't streamed in yet */
+	UAnimMontage* GetFiringMontage() const;
+
 public:
 
 	/** Returns the first person mesh */
@@ -167,13 +248,39 @@ public:
 	USkeletalMeshComponent* GetThirdPersonMesh() const { return ThirdPersonMesh; };
 
 	/** Returns the first person anim instance class */
-	const TSubclassOf<UAnimInstance>& GetFirstPersonAnimInstanceClass() const;
+	TSubclassOf<UAnimInstance> GetFirstPersonAnimInstanceClass() const;
 
 	/** Returns the third person anim instance class */
-	const TSubclassOf<UAnimInstance>& GetThirdPersonAnimInstanceClass() const;
+	TSubclassOf<UAnimInstance> GetThirdPersonAnimInstanceClass() const;
+
+	/** Returns the first person anim layer class */
+	TSubclassOf<UAnimInstance> GetFirstPersonAnimLayerClass() const { return FirstPersonAnimLayerClass.Get(); }
+
+	/** Returns the third person anim layer class */
+	TSubclassOf<UAnimInstance> GetThirdPersonAnimLayerClass() const { return ThirdPersonAnimLayerClass.Get(); }
+
+	/** Adds the paths of every soft referenced asset this weapon needs to fire and animate, including the archetype's sounds */
+	void GetSoftAssetPaths(TArray<FSoftObjectPath>& OutPaths, const FShooterWeaponArchetype& WeaponArchetype) const;
+
+#if WITH_EDITOR
+	/** Fills a table row with this weapon's deprecated tuning properties. Used to bake a row for weapons that have none */
+	virtual void GetFallbackTuning(FWeaponTableRow& OutRow) const;
+#endif // WITH_EDITOR
+
+	/** Looks up the compiled archetype for this weapon's row or class. Weapons without a row get their fallback archetype in the editor. Safe to call on the class default object */
+	const FShooterWeaponArchetype& FindArchetype(const UGameInstance* GameInstance, int32* OutIndex = nullptr) const;
+
+	/** Returns true once the weapon's soft referenced assets have streamed in */
+	bool AreAssetsLoaded() const { return bAssetsLoaded; }
+
+	/** Returns the weapon data table row this weapon names, if any */
+	FName GetArchetypeRow() const { return ArchetypeRow; }
+
+	/** Returns the compiled tuning for this weapon */
+	const FShooterWeaponArchetype& GetArchetype() const { return *Archetype; }
 
 	/** Returns the magazine size */
-	int32 GetMagazineSize() const { return MagazineSize; };
+	int32 GetMagazineSize() const { return Archetype->MagazineSize; };
 
 	/** Returns the current bullet count */
 	int32 GetBulletCount() const { return CurrentBullets; }
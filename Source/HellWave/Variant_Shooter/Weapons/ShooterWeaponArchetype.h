@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/SoftObjectPtr.h"
+
+class UDamageType;
+class USoundBase;
+
+/**
+ *  Immutable weapon tuning, compiled from a weapon data table row
+ *  Shared by every weapon instance of the same archetype
+ *  Values read on every shot are packed first so firing touches as few cache lines as possible
+ */
+struct FShooterWeaponArchetype
+{
+	// fire path
+
+	/** Time between shots. Affects both full auto and semi auto modes */
+	float RefireRate = 0.5f;
+
+	/** Distance ahead of the muzzle that bullets will spawn at */
+	float MuzzleOffset = 10.0f;
+
+	/** Cone half-angle for variance while aiming */
+	float AimVariance = 0.0f;
+
+	/** Amount of firing recoil to apply to the owner */
+	float FiringRecoil = 0.0f;
+
+	/** Number of bullets in a magazine */
+	int32 MagazineSize = 10;
+
+	/** Number of traces fired per hitscan shot */
+	int32 PelletCount = 1;
+
+	/** Half-angle of the pellet spread cone */
+	float SpreadHalfAngle = 0.0f;
+
+	/** Precomputed pellet directions in the aim frame, with X forward. SpreadVariants layouts of PelletCount directions each */
+	TArray<FVector> SpreadDirections;
+
+	/** Number of layouts in SpreadDirections */
+	int32 SpreadVariants = 0;
+
+	/** Max range of hitscan traces */
+	float HitscanRange = 5000.0f;
+
+	/** Damage applied by each hitscan trace */
+	float HitscanDamage = 25.0f;
+
+	/** Impulse applied to physics objects by each hitscan trace */
+	float HitscanImpulse = 100.0f;
+
+	/** If true, the weapon automatically fires at the refire rate */
+	bool bFullAuto = false;
+
+	/** If true, the weapon fires hitscan traces instead of projectiles */
+	bool bShouldFireHitscan = true;
+
+	/** If true, the weapon reloads from reserve when the magazine is empty */
+	bool bAutoReloadFromReserve = true;
+
+	// cold data
+
+	/** Name of the first person muzzle socket */
+	FName MuzzleSocketName;
+
+	/** Tag applied to noise generated by shooting */
+	FName ShotNoiseTag = FName("Shot");
+
+	/** Loudness of the shot for AI perception */
+	float ShotLoudness = 1.0f;
+
+	/** Max range of shot AI perception noise */
+	float ShotNoiseRange = 3000.0f;
+
+	/** Maximum reserve ammo capacity */
+	int32 MaxReserveAmmo = 50;
+
+	/** Reserve ammo the weapon starts with */
+	int32 StartingReserveAmmo = 50;
+
+	/** Time to reload from reserve */
+	float ReloadTime = 0.5f;
+
+	/** Damage type applied by hitscan traces. Kept loaded by the weapon data table */
+	TSubclassOf<UDamageType> HitscanDamageType;
+
+	/** Sound posted to the audio event layer for each shot. Kept loaded by the weapon */
+	TSoftObjectPtr<USoundBase> FireSound;
+
+	/** Sound played for shots collapsed into crowd gunfire. Kept loaded by the weapon */
+	TSoftObjectPtr<USoundBase> CrowdFireSound;
+
+	/** Tuning used by weapons that have no data table row */
+	static const FShooterWeaponArchetype Default;
+};
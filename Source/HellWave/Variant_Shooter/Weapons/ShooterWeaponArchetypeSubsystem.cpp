@@ -0,0 +1,368 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterWeaponArchetypeSubsystem.h"
+#include "ShooterPickup.h"
+#include "ShooterWeapon.h"
+#include "Engine/DataTable.h"
+#include "HellWave.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "UObject/ObjectSaveContext.h"
+#endif
+
+const FShooterWeaponArchetype FShooterWeaponArchetype::Default;
+
+#if WITH_EDITOR
+namespace
+{
+	/** Hooks the fallback row bake into cooking once the engine is up */
+	FDelayedAutoRegisterHelper FallbackRowBakeRegistration(EDelayedRegisterRunPhase::EndOfEngineInit, []
+	{
+		FCoreUObjectDelegates::OnObjectPreSave.AddStatic(&UShooterWeaponArchetypeSubsystem::OnObjectPreSave);
+	});
+}
+#endif // WITH_EDITOR
+
+void UShooterWeaponArchetypeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// weapons resolve their archetype on BeginPlay, so the table has to be ready before any world starts
+	LoadedTable = WeaponDataTable.LoadSynchronous();
+
+	if (!LoadedTable && !WeaponDataTable.IsNull())
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("Weapon archetypes: could not load %s. Weapons will use default tuning."), *WeaponDataTable.ToString());
+	}
+
+	CompileArchetypes(LoadedTable);
+}
+
+void UShooterWeaponArchetypeSubsystem::Deinitialize()
+{
+	Archetypes.Empty();
+	IndicesByRowName.Empty();
+	IndicesByWeaponClass.Empty();
+#if WITH_EDITOR
+	FallbackArchetypes.Empty();
+#endif
+	LoadedTable = nullptr;
+
+	Super::Deinitialize();
+}
+
+int32 UShooterWeaponArchetypeSubsystem::FindArchetypeIndex(FName RowName) const
+{
+	const int32* Index = IndicesByRowName.Find(RowName);
+	return Index ? *Index : INDEX_NONE;
+}
+
+int32 UShooterWeaponArchetypeSubsystem::FindArchetypeIndex(const UClass* WeaponClass) const
+{
+	// walk up the hierarchy so Blueprint children share their parent's row
+	for (const UClass* Class = WeaponClass; Class; Class = Class->GetSuperClass())
+	{
+		if (const int32* Index = IndicesByWeaponClass.Find(FSoftObjectPath(Class)))
+		{
+			return *Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+const FShooterWeaponArchetype& UShooterWeaponArchetypeSubsystem::GetArchetype(int32 Index) const
+{
+	return Archetypes.IsValidIndex(Index) ? Archetypes[Index] : FShooterWeaponArchetype::Default;
+}
+
+#if WITH_EDITOR
+const FShooterWeaponArchetype& UShooterWeaponArchetypeSubsystem::FindOrAddFallbackArchetype(const AShooterWeapon* WeaponDefaults)
+{
+	if (!WeaponDefaults)
+	{
+		return FShooterWeaponArchetype::Default;
+	}
+
+	TUniquePtr<FShooterWeaponArchetype>& Fallback = FallbackArchetypes.FindOrAdd(WeaponDefaults->GetClass());
+
+	if (!Fallback)
+	{
+		// compile the properties like a table row, so the fallback gets the same spread tables and clamping
+		FWeaponTableRow Row;
+		WeaponDefaults->GetFallbackTuning(Row);
+
+		Fallback = MakeUnique<FShooterWeaponArchetype>(CompileRow(Row));
+	}
+
+	return *Fallback;
+}
+
+void UShooterWeaponArchetypeSubsystem::BakeFallbackRows(UDataTable* Table)
+{
+	if (!Table || Table->GetRowStruct() != FWeaponTableRow::StaticStruct())
+	{
+		return;
+	}
+
+	// weapon classes that already have a row
+	TSet<FSoftObjectPath> ClassesWithRows;
+
+	for (const TPair<FName, uint8*>& RowPair : Table->GetRowMap())
+	{
+		const FWeaponTableRow& Row = *reinterpret_cast<const FWeaponTableRow*>(RowPair.Value);
+		ClassesWithRows.Add(Row.WeaponToSpawn.ToSoftObjectPath());
+	}
+
+	// ask the asset registry, so Blueprint weapons that aren't loaded are found too
+	TSet<FTopLevelAssetPath> WeaponClassPaths;
+	IAssetRegistry::GetChecked().GetDerivedClassNames({ AShooterWeapon::StaticClass()->GetClassPathName() }, {}, WeaponClassPaths);
+
+	int32 NumBaked = 0;
+
+	for (const FTopLevelAssetPath& WeaponClassPath : WeaponClassPaths)
+	{
+		UClass* WeaponClass = TSoftClassPtr<AShooterWeapon>(FSoftObjectPath(WeaponClassPath)).LoadSynchronous();
+
+		if (!WeaponClass || WeaponClass->HasAnyClassFlags(CLASS_Abstract))
+		{
+			continue;
+		}
+
+		const AShooterWeapon* WeaponDefaults = WeaponClass->GetDefaultObject<AShooterWeapon>();
+
+		// weapons that name their row are looked up by name, everything else by its class or closest parent
+		FName RowName = WeaponDefaults->GetArchetypeRow();
+		bool bHasRow = !RowName.IsNone() && Table->GetRowMap().Contains(RowName);
+
+		for (const UClass* Class = WeaponClass; Class && !bHasRow && RowName.IsNone(); Class = Class->GetSuperClass())
+		{
+			bHasRow = ClassesWithRows.Contains(FSoftObjectPath(Class));
+		}
+
+		if (bHasRow)
+		{
+			continue;
+		}
+
+		FWeaponTableRow Row;
+		WeaponDefaults->GetFallbackTuning(Row);
+
+		if (RowName.IsNone())
+		{
+			Row.WeaponToSpawn = WeaponClass;
+			RowName = FName(*FString::Printf(TEXT("Fallback_%s"), *WeaponClass->GetName()));
+		}
+
+		Table->AddRow(RowName, Row);
+		++NumBaked;
+
+		UE_LOG(LogHellWave, Warning, TEXT("Weapon archetypes: baked fallback row %s for %s. Move its tuning into %s."), *RowName.ToString(), *WeaponClass->GetName(), *Table->GetName());
+	}
+
+	if (NumBaked > 0)
+	{
+		UE_LOG(LogHellWave, Log, TEXT("Weapon archetypes: baked %d fallback rows into %s."), NumBaked, *Table->GetName());
+	}
+}
+
+void UShooterWeaponArchetypeSubsystem::OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext)
+{
+	if (!SaveContext.IsCooking())
+	{
+		return;
+	}
+
+	UDataTable* Table = Cast<UDataTable>(Object);
+
+	if (Table && FSoftObjectPath(Table) == GetDefault<UShooterWeaponArchetypeSubsystem>()->WeaponDataTable.ToSoftObjectPath())
+	{
+		BakeFallbackRows(Table);
+	}
+}
+#endif // WITH_EDITOR
+
+void UShooterWeaponArchetypeSubsystem::CompileArchetypes(const UDataTable* Table)
+{
+	const int32 NumRows = Table ? Table->GetRowMap().Num() : 0;
+
+	// size the array once so it stays contiguous and never reallocates
+	Archetypes.Empty(NumRows + 1);
+	Archetypes.Add(FShooterWeaponArchetype::Default);
+
+	IndicesByRowName.Empty(NumRows);
+	IndicesByWeaponClass.Empty(NumRows);
+
+	if (!Table)
+	{
+		return;
+	}
+
+	if (Table->GetRowStruct() != FWeaponTableRow::StaticStruct())
+	{
+		UE_LOG(LogHellWave, Warning, TEXT("Weapon archetypes: %s does not use FWeaponTableRow."), *Table->GetName());
+		return;
+	}
+
+	for (const TPair<FName, uint8*>& RowPair : Table->GetRowMap())
+	{
+		const FWeaponTableRow& Row = *reinterpret_cast<const FWeaponTableRow*>(RowPair.Value);
+
+		const int32 Index = Archetypes.Add(CompileRow(Row));
+		IndicesByRowName.Add(RowPair.Key, Index);
+
+		// the first row that grants a class owns its tuning
+		if (!Row.WeaponToSpawn.IsNull() && !IndicesByWeaponClass.Contains(Row.WeaponToSpawn.ToSoftObjectPath()))
+		{
+			IndicesByWeaponClass.Add(Row.WeaponToSpawn.ToSoftObjectPath(), Index);
+		}
+	}
+
+	UE_LOG(LogHellWave, Log, TEXT("Weapon archetypes: compiled %d rows from %s, %d bytes."), NumRows, *Table->GetName(), static_cast<int32>(Archetypes.GetAllocatedSize()));
+}
+
+FShooterWeaponArchetype UShooterWeaponArchetypeSubsystem::CompileRow(const FWeaponTableRow& Row)
+{
+	FShooterWeaponArchetype Archetype;
+
+	Archetype.RefireRate = Row.RefireRate;
+	Archetype.MuzzleOffset = Row.MuzzleOffset;
+	Archetype.AimVariance = Row.AimVariance;
+	Archetype.FiringRecoil = Row.FiringRecoil;
+	Archetype.MagazineSize = Row.MagazineSize;
+	Archetype.PelletCount = FMath::Max(1, Row.PelletCount);
+	Archetype.SpreadHalfAngle = Row.SpreadHalfAngle;
+	Archetype.HitscanRange = Row.HitscanRange;
+	Archetype.HitscanDamage = Row.HitscanDamage;
+	Archetype.HitscanImpulse = Row.HitscanImpulse;
+	Archetype.bFullAuto = Row.bFullAuto;
+	Archetype.bShouldFireHitscan = Row.bShouldFireHitscan;
+	Archetype.bAutoReloadFromReserve = Row.bAutoReloadFromReserve;
+	Archetype.MuzzleSocketName = Row.MuzzleSocketName;
+	Archetype.ShotNoiseTag = Row.ShotNoiseTag;
+	Archetype.ShotLoudness = Row.ShotLoudness;
+	Archetype.ShotNoiseRange = Row.ShotNoiseRange;
+	Archetype.MaxReserveAmmo = Row.MaxReserveAmmo;
+	Archetype.StartingReserveAmmo = FMath::Min(Row.StartingReserveAmmo, Row.MaxReserveAmmo);
+	Archetype.ReloadTime = Row.ReloadTime;
+	Archetype.HitscanDamageType = Row.HitscanDamageType;
+	Archetype.FireSound = Row.FireSound;
+	Archetype.CrowdFireSound = Row.CrowdFireSound;
+
+	BuildSpreadDirections(Row, Archetype);
+
+	return Archetype;
+}
+
+void UShooterWeaponArchetypeSubsystem::BuildSpreadDirections(const FWeaponTableRow& Row, FShooterWeaponArchetype& Archetype)
+{
+	// single pellet weapons fire straight along the aim
+	if (Archetype.PelletCount <= 1)
+	{
+		return;
+	}
+
+	const int32 NumPellets = Archetype.PelletCount;
+	const float HalfAngleRad = FMath::DegreesToRadians(Archetype.SpreadHalfAngle);
+
+	Archetype.SpreadVariants = FMath::Max(1, Row.SpreadVariants);
+	Archetype.SpreadDirections.Reset(Archetype.SpreadVariants * NumPellets);
+
+	// maps a point in the unit disk to a direction in the spread cone
+	auto DiskToCone = [HalfAngleRad](const FVector2D& DiskPoint)
+	{
+		const float ConeAngle = DiskPoint.Size() * HalfAngleRad;
+		const float Azimuth = FMath::Atan2(DiskPoint.Y, DiskPoint.X);
+
+		return FVector(FMath::Cos(ConeAngle), FMath::Sin(ConeAngle) * FMath::Cos(Azimuth), FMath::Sin(ConeAngle) * FMath::Sin(Azimuth));
+	};
+
+	// uniform point in the unit disk
+	auto RandomDiskPoint = [](FRandomStream& Stream)
+	{
+		const float Radius = FMath::Sqrt(Stream.GetFraction());
+		const float Azimuth = Stream.GetFraction() * UE_TWO_PI;
+
+		return FVector2D(Radius * FMath::Cos(Azimuth), Radius * FMath::Sin(Azimuth));
+	};
+
+	TArray<FVector2D> DiskPoints;
+	DiskPoints.Reserve(NumPellets);
+
+	for (int32 Variant = 0; Variant < Archetype.SpreadVariants; ++Variant)
+	{
+		FRandomStream Stream(Row.SpreadSeed + Variant);
+		DiskPoints.Reset();
+
+		switch (Row.SpreadPattern)
+		{
+		case EShooterSpreadPattern::FixedRing:
+		{
+			// center pellet, then a ring rotated a little further on each variant
+			DiskPoints.Add(FVector2D::ZeroVector);
+
+			const int32 NumRing = NumPellets - 1;
+			const float Step = UE_TWO_PI / NumRing;
+			const float Offset = Step * Variant / Archetype.SpreadVariants;
+
+			for (int32 RingIndex = 0; RingIndex < NumRing; ++RingIndex)
+			{
+				const float Azimuth = Offset + Step * RingIndex;
+				DiskPoints.Add(FVector2D(FMath::Cos(Azimuth), FMath::Sin(Azimuth)) * 0.75f);
+			}
+
+			break;
+		}
+
+		case EShooterSpreadPattern::PoissonDisk:
+		{
+			// dart throwing with a spacing that fits the pellet count, relaxed when a dart can't be placed
+			float MinDistance = 1.5f / FMath::Sqrt(static_cast<float>(NumPellets));
+
+			while (DiskPoints.Num() < NumPellets)
+			{
+				bool bPlaced = false;
+
+				for (int32 Attempt = 0; Attempt < 32 && !bPlaced; ++Attempt)
+				{
+					const FVector2D Candidate = RandomDiskPoint(Stream);
+
+					bPlaced = !DiskPoints.ContainsByPredicate([&Candidate, MinDistance](const FVector2D& Placed)
+					{
+						return FVector2D::DistSquared(Candidate, Placed) < FMath::Square(MinDistance);
+					});
+
+					if (bPlaced)
+					{
+						DiskPoints.Add(Candidate);
+					}
+				}
+
+				if (!bPlaced)
+				{
+					MinDistance *= 0.9f;
+				}
+			}
+
+			break;
+		}
+
+		default:
+		{
+			for (int32 PelletIndex = 0; PelletIndex < NumPellets; ++PelletIndex)
+			{
+				DiskPoints.Add(RandomDiskPoint(Stream));
+			}
+
+			break;
+		}
+		}
+
+		for (const FVector2D& DiskPoint : DiskPoints)
+		{
+			Archetype.SpreadDirections.Add(DiskToCone(DiskPoint));
+		}
+	}
+}
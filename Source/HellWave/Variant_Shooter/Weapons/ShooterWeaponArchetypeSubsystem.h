@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ShooterWeaponArchetype.h"
+#include "ShooterWeaponArchetypeSubsystem.generated.h"
+
+class UDataTable;
+class AShooterWeapon;
+struct FWeaponTableRow;
+class FObjectPreSaveContext;
+
+/**
+ *  Compiles the weapon data table into a contiguous, immutable archetype array when the game starts
+ *  Weapons look up their archetype once and read all of their tuning through it
+ *  Index 0 is always the default archetype
+ *  In the editor, weapons that have no data table row get a fallback archetype built once per class from their deprecated tuning properties
+ *  When the table is cooked, those weapons get a row baked from the same properties, so cooked weapons don't carry them
+ */
+UCLASS(Config=Game)
+class HELLWAVE_API UShooterWeaponArchetypeSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+	/** Weapon data table to compile. Set in DefaultGame.ini */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> WeaponDataTable;
+
+	/** Keeps the table, and the classes its rows reference, resident */
+	UPROPERTY(Transient)
+	TObjectPtr<UDataTable> LoadedTable;
+
+	/** Compiled archetypes. Never resized after compiling, so references stay valid */
+	TArray<FShooterWeaponArchetype> Archetypes;
+
+	/** Archetype indices, keyed by data table row name */
+	TMap<FName, int32> IndicesByRowName;
+
+	/** Archetype indices, keyed by the weapon class their row grants */
+	TMap<FSoftObjectPath, int32> IndicesByWeaponClass;
+
+#if WITH_EDITOR
+	/** Archetypes built from the tuning properties of weapon classes that have no row. Heap allocated so references stay valid */
+	TMap<TObjectKey<UClass>, TUniquePtr<FShooterWeaponArchetype>> FallbackArchetypes;
+#endif // WITH_EDITOR
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Returns the archetype index compiled from the named row, or INDEX_NONE */
+	int32 FindArchetypeIndex(FName RowName) const;
+
+	/** Returns the archetype index of the row that grants this weapon class or its closest parent, or INDEX_NONE */
+	int32 FindArchetypeIndex(const UClass* WeaponClass) const;
+
+	/** Returns the archetype at the index. Invalid indices return the default archetype */
+	const FShooterWeaponArchetype& GetArchetype(int32 Index) const;
+
+#if WITH_EDITOR
+	/** Returns the archetype built from the weapon's deprecated tuning properties, building it on first use. Pass the class default object */
+	const FShooterWeaponArchetype& FindOrAddFallbackArchetype(const AShooterWeapon* WeaponDefaults);
+
+	/** Adds a row, built from the deprecated tuning properties, for every weapon class the table has no row for */
+	static void BakeFallbackRows(UDataTable* Table);
+
+	/** Bakes the fallback rows into the weapon data table when it's saved for cooking */
+	static void OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext);
+#endif // WITH_EDITOR
+
+	/** Returns the number of compiled archetypes, including the default */
+	int32 GetNumArchetypes() const { return Archetypes.Num(); }
+
+protected:
+
+	/** Builds the archetype array and lookup maps from the table */
+	void CompileArchetypes(const UDataTable* Table);
+
+	/** Copies the tuning values out of a table row */
+	static FShooterWeaponArchetype CompileRow(const FWeaponTableRow& Row);
+
+	/** Precomputes the row's pellet spread layouts into the archetype */
+	static void BuildSpreadDirections(const FWeaponTableRow& Row, FShooterWeaponArchetype& Archetype);
+};
@@ -2,5 +2,12 @@
 
 
 #include "ShooterWeaponHolder.h"
+#include "ShooterWeapon.h"
+#include "Components/SkeletalMeshComponent.h"
 
 // Add default functionality here for any IShooterWeaponHolder functions that are not pure virtual.
+
+FVector IShooterWeaponHolder::GetWeaponMuzzleLocation(const AShooterWeapon* Weapon)
+{
+	return Weapon->GetFirstPersonMesh()->GetSocketLocation(Weapon->GetArchetype().MuzzleSocketName);
+}
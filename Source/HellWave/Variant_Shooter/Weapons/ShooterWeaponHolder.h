@@ -41,6 +41,9 @@ public:
 	/** Calculates and returns the aim location for the weapon */
 	virtual FVector GetWeaponTargetLocation() = 0;
 
+	/** Returns the world location of the weapon's muzzle. Owners can override this to share a cached value */
+	virtual FVector GetWeaponMuzzleLocation(const AShooterWeapon* Weapon);
+
 	/** Gives a weapon of this class to the owner */
 	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) = 0;
 